@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+Number of heap allocations made by the process so far.
+Linking allocation_counter.cpp replaces the global operator new to count them. It lives in its own
+translation unit so that no call to the replaced operators is inlined next to malloc and free.
+*/
+[[nodiscard]] uint64_t allocation_count() noexcept;
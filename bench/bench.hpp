@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "misc.hpp"
+
+/* Minimal micro-benchmark harness: untimed setup, timed body, median and MAD over repetitions */
+namespace bench
+{
+    struct Options
+    {
+        std::string output_filepath = "bench_results.json";
+        std::string filter = ""; /* Only benchmarks whose name contains it */
+        size_t warmup = 3;
+        size_t repetitions = 15;
+    };
+
+    struct Result
+    {
+        std::string name;
+        size_t entities = 0;
+        size_t repetitions = 0;
+        double median_ns = 0.0;
+        double mad_ns = 0.0; /* Median absolute deviation */
+        double min_ns = 0.0;
+    };
+
+    [[nodiscard]] inline std::string next_value(int argc, char *argv[], int &i)
+    {
+        if (i + 1 >= argc)
+            throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        return argv[++i];
+    }
+
+    /* Keeps the optimizer from removing the measured work */
+    inline void keep(uint64_t value) noexcept
+    {
+        static volatile uint64_t sink = 0;
+        sink = sink + value;
+    }
+
+    [[nodiscard]] inline double median(std::vector<double> values) noexcept
+    {
+        if (values.empty())
+            return 0.0;
+        const size_t mid = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + mid, values.end());
+        if (values.size() % 2 == 1)
+            return values[mid];
+        const double upper = values[mid];
+        return 0.5 * (upper + *std::max_element(values.begin(), values.begin() + mid));
+    }
+
+    class Suite
+    {
+    public:
+        explicit Suite(const Options &options) noexcept : m_options(options)
+        {
+        }
+
+        template <typename Setup, typename Body>
+        void run(const std::string &name, size_t entities, Setup &&setup, Body &&body)
+        {
+            if (!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos)
+                return;
+
+            std::vector<double> times;
+            times.reserve(m_options.repetitions);
+            for (size_t i = 0; i < m_options.warmup + m_options.repetitions; ++i)
+            {
+                setup();
+                const auto start = std::chrono::steady_clock::now();
+                body();
+                const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                if (i >= m_options.warmup)
+                    times.push_back(elapsed.count());
+            }
+
+            Result result;
+            result.name = name;
+            result.entities = entities;
+            result.repetitions = times.size();
+            result.median_ns = median(times);
+            result.min_ns = times.empty() ? 0.0 : *std::min_element(times.begin(), times.end());
+            std::vector<double> deviations;
+            for (const double time : times)
+                deviations.push_back(std::abs(time - result.median_ns));
+            result.mad_ns = median(deviations);
+
+            std::cout << name << " [" << entities << "]: " << float_to_string(result.median_ns / 1000.0, 2) << " us +- "
+                      << float_to_string(result.mad_ns / 1000.0, 2) << " us ("
+                      << float_to_string(result.median_ns / static_cast<double>(std::max<size_t>(1, entities)), 2)
+                      << " ns/entity)" << std::endl;
+            m_results.push_back(result);
+        }
+
+        void write_json(std::ostream &out) const
+        {
+            out << "{\n  \"warmup\": " << m_options.warmup << ",\n  \"repetitions\": " << m_options.repetitions
+                << ",\n  \"benchmarks\": [\n";
+            for (size_t i = 0; i < m_results.size(); ++i)
+            {
+                const auto &r = m_results[i];
+                out << "    {\"name\": \"" << r.name << "\", \"entities\": " << r.entities
+                    << ", \"repetitions\": " << r.repetitions << ", \"median_ns\": " << r.median_ns
+                    << ", \"mad_ns\": " << r.mad_ns << ", \"min_ns\": " << r.min_ns << ", \"ns_per_entity\": "
+                    << r.median_ns / static_cast<double>(std::max<size_t>(1, r.entities)) << '}'
+                    << (i + 1 < m_results.size() ? ",\n" : "\n");
+            }
+            out << "  ]\n}\n";
+        }
+
+    private:
+        Options m_options;
+        std::vector<Result> m_results;
+    };
+}
@@ -0,0 +1,204 @@
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "bench.hpp"
+#include "entity_manager.hpp"
+#include "random.hpp"
+
+/*
+EntityManager micro-benchmarks, the baseline for any storage redesign
+Populations mirror the game: one player, 85% enemies with shapes, 15% bullets with a lifespan
+*/
+namespace
+{
+    constexpr std::array<size_t, 3> sizes = {1000, 10000, 100000};
+    constexpr std::array<float, 4> death_ratios = {0.0f, 0.1f, 0.5f, 0.9f};
+    constexpr uint64_t bench_seed = 42;
+
+    void populate(EntityManager &entities, size_t count)
+    {
+        entities.clear();
+        Rng rng(bench_seed, 0);
+
+        auto player = entities.add_entity("player");
+        player->add<CTransform>(sf::Vector2f{0.0f, 0.0f}, sf::Vector2f{0.0f, 0.0f}, 2.0f);
+        player->add<CCollision>(20.0f);
+        player->add<CInput>();
+        player->add<CShape>(20.0f, 5, sf::Color::White);
+
+        for (size_t i = 1; i < count; ++i)
+        {
+            const sf::Vector2f pos = {rng.uniform(-640.0f, 640.0f), rng.uniform(-360.0f, 360.0f)};
+            const sf::Vector2f velocity = {rng.uniform(-8.0f, 8.0f), rng.uniform(-8.0f, 8.0f)};
+            if (i % 20 < 3)
+            {
+                auto bullet = entities.add_entity("bullet");
+                bullet->add<CTransform>(pos, velocity, 0.0f);
+                bullet->add<CCollision>(5.0f);
+                bullet->add<CLifeSpan>(30);
+                bullet->add<CShape>(5.0f, 36, sf::Color::White);
+            }
+            else
+            {
+                const unsigned sides = rng.uniform_int(3, 10);
+                auto enemy = entities.add_entity("enemy");
+                enemy->add<CTransform>(pos, velocity, 2.0f);
+                enemy->add<CCollision>(20.0f);
+                enemy->add<CScore>(100 * static_cast<int>(sides));
+                enemy->add<CShape>(20.0f, sides, sf::Color::Red);
+            }
+        }
+        entities.update();
+    }
+
+    void kill(EntityManager &entities, float ratio)
+    {
+        Rng rng(bench_seed, 1);
+        for (auto &e : entities.get_entities())
+        {
+            if (rng.uniform(0.0f, 1.0f) < ratio)
+                e->destroy();
+        }
+    }
+
+    [[nodiscard]] bench::Options parse_bench_cli(int argc, char *argv[], bool &show_help)
+    {
+        bench::Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help")
+                show_help = true;
+            else if (arg == "--output")
+                options.output_filepath = bench::next_value(argc, argv, i);
+            else if (arg == "--filter")
+                options.filter = bench::next_value(argc, argv, i);
+            else if (arg == "--warmup")
+                options.warmup = std::stoul(bench::next_value(argc, argv, i));
+            else if (arg == "--repetitions")
+                options.repetitions = std::stoul(bench::next_value(argc, argv, i));
+            else
+                throw std::runtime_error("Unknown option " + arg);
+        }
+        return options;
+    }
+
+    void run_benchmarks(bench::Suite &suite)
+    {
+        EntityManager entities;
+
+        for (const size_t n : sizes)
+        {
+            suite.run("add_entity", n, [&]
+                      { entities.clear(); },
+                      [&]
+                      {
+                          for (size_t i = 0; i < n; ++i)
+                              bench::keep(entities.add_entity("enemy")->id());
+                      });
+
+            suite.run("add_entity+update", n, [&]
+                      { entities.clear(); },
+                      [&]
+                      {
+                          for (size_t i = 0; i < n; ++i)
+                              entities.add_entity(i % 20 < 3 ? "bullet" : "enemy")->add<CTransform>();
+                          entities.update();
+                      });
+
+            for (const float ratio : death_ratios)
+            {
+                suite.run("update_dead_" + std::to_string(static_cast<int>(100.0f * ratio)) + "pct", n, [&]
+                          {
+                              populate(entities, n);
+                              kill(entities, ratio);
+                          },
+                          [&]
+                          { entities.update(); });
+            }
+
+            populate(entities, n);
+            const std::array<std::string, 4> tags = {"enemy", "bullet", "player", "missing"};
+
+            suite.run("get_entities_tag", n, [] {}, [&]
+                      {
+                          for (size_t i = 0; i < n; ++i)
+                              bench::keep(entities.get_entities(tags[i % tags.size()]).size());
+                      });
+
+            suite.run("has_component", n, [] {}, [&]
+                      {
+                          uint64_t count = 0;
+                          for (const auto &e : entities.get_entities())
+                              count += e->has<CLifeSpan>();
+                          bench::keep(count);
+                      });
+
+            suite.run("get_component", n, [] {}, [&]
+                      {
+                          float sum = 0.0f;
+                          for (const auto &e : entities.get_entities())
+                              sum += e->get<CTransform>().pos.x;
+                          bench::keep(static_cast<uint64_t>(sum));
+                      });
+
+            /* Movement system shape: filter, read and write */
+            suite.run("iterate_all", n, [] {}, [&]
+                      {
+                          for (const auto &e : entities.get_entities())
+                          {
+                              if (!e->has<CTransform>())
+                                  continue;
+                              auto &transform = e->get<CTransform>();
+                              transform.pos += transform.velocity;
+                          }
+                          bench::keep(static_cast<uint64_t>(entities.get_entities().front()->get<CTransform>().pos.x));
+                      });
+
+            suite.run("iterate_tag", n, [] {}, [&]
+                      {
+                          float sum = 0.0f;
+                          for (const auto &e : entities.get_entities("enemy"))
+                              sum += e->get<CCollision>().radius;
+                          bench::keep(static_cast<uint64_t>(sum));
+                      });
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        bool show_help = false;
+        const bench::Options options = parse_bench_cli(argc, argv, show_help);
+        if (show_help)
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n"
+                      << "  --output FILE              JSON results (default bench_results.json)\n"
+                      << "  --filter TEXT              Only run benchmarks whose name contains TEXT\n"
+                      << "  --warmup N                 Untimed repetitions (default 3)\n"
+                      << "  --repetitions N            Timed repetitions (default 15)\n"
+                      << "  -h, --help                 Show this message\n";
+            return 0;
+        }
+
+        bench::Suite suite(options);
+        run_benchmarks(suite);
+
+        std::ofstream output(options.output_filepath);
+        if (!output)
+            throw std::runtime_error("Could not open " + options.output_filepath);
+        suite.write_json(output);
+        std::cout << "Results in " << options.output_filepath << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
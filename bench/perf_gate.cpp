@@ -0,0 +1,371 @@
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "allocation_counter.hpp"
+#include "bench.hpp"
+#include "game.hpp"
+
+/*
+Performance regression gate
+Plays fixed, seeded headless scenarios several times, after one untimed warmup run, and compares the median
+time of every system and the median heap allocation count of a run against the checked-in bench/perf_baseline.json.
+The scenarios are seeded bot runs rather than recorded replays: the simulation is deterministic for a seed, so
+they play the same ticks every time without binary files to re-record when the replay format changes.
+Exits with 1 on a regression. --update writes the current numbers as a new baseline to --output instead.
+*/
+
+namespace
+{
+    struct PerfScenario
+    {
+        std::string name;
+        uint64_t seed = 0;
+        BotPolicy bot = BotPolicy::Scripted;
+        uint64_t ticks = 0;
+        std::string scenario_filepath = "";
+    };
+
+    struct PerfResult
+    {
+        uint64_t allocations = 0;
+        std::map<std::string, double> median_us; /* Per system, plus the whole tick */
+    };
+
+    struct Tolerance
+    {
+        double time = 0.25;         /* Relative increase of a median time */
+        double time_floor_us = 1.0; /* Increases below it are noise */
+        double allocations = 0.02;  /* Relative increase of the allocation count */
+    };
+
+    struct PerfOptions
+    {
+        std::string config_filepath = "../resources/config.toml";
+        std::string baseline_filepath = "../bench/perf_baseline.json";
+        std::string output_filepath = "perf_baseline.json";
+        std::string scenario_dirpath = "../resources/scenarios/";
+        size_t repetitions = 5;
+        bool update = false;
+        bool show_help = false;
+    };
+
+    [[nodiscard]] std::vector<PerfScenario> perf_scenarios(const PerfOptions &options)
+    {
+        return {
+            {"scripted", 1, BotPolicy::Scripted, 3600, ""},
+            {"berserk", 2, BotPolicy::Berserk, 3600, ""},
+            {"stress", 3, BotPolicy::Berserk, 0, options.scenario_dirpath + "perf_gate.toml"},
+        };
+    }
+
+    [[nodiscard]] PerfResult run_scenario(const PerfScenario &scenario, const PerfOptions &options)
+    {
+        GameOptions game_options;
+        game_options.headless = true;
+        game_options.profile = false;
+        game_options.print_summary = false;
+        game_options.collect_stats = true;
+        game_options.seed = scenario.seed;
+        game_options.bot = scenario.bot;
+        game_options.max_ticks = scenario.ticks;
+        game_options.scenario_filepath = scenario.scenario_filepath;
+
+        std::map<std::string, std::vector<double>> samples;
+        std::vector<double> allocation_counts;
+
+        /* Untimed warmup: the first game of a process allocates more (lazy statics, first file reads) and runs cold */
+        {
+            Game game(options.config_filepath, game_options);
+            game.run();
+        }
+
+        for (size_t i = 0; i < options.repetitions; ++i)
+        {
+            const uint64_t allocations_before = allocation_count();
+            const auto start = std::chrono::steady_clock::now();
+
+            Game game(options.config_filepath, game_options);
+            game.run();
+
+            const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+            allocation_counts.push_back(static_cast<double>(allocation_count() - allocations_before));
+
+            const RunStats &stats = game.stats();
+            for (size_t id = 0; id < system_names.size(); ++id)
+                samples[system_names[id]].push_back(stats.average_us(static_cast<SystemId>(id)));
+            samples["tick"].push_back(elapsed.count() / static_cast<double>(std::max<uint64_t>(1, stats.ticks)));
+        }
+
+        PerfResult result;
+        result.allocations = static_cast<uint64_t>(bench::median(allocation_counts));
+        for (const auto &[name, values] : samples)
+            result.median_us[name] = bench::median(values);
+        return result;
+    }
+
+    /* Just enough JSON for the baseline file: nested objects of numbers */
+    struct JsonObject
+    {
+        std::map<std::string, double> numbers;
+        std::map<std::string, JsonObject> objects;
+
+        [[nodiscard]] const JsonObject *find(const std::string &key) const noexcept
+        {
+            const auto it = objects.find(key);
+            return it != objects.end() ? &it->second : nullptr;
+        }
+
+        [[nodiscard]] double find_or(const std::string &key, double fallback) const noexcept
+        {
+            const auto it = numbers.find(key);
+            return it != numbers.end() ? it->second : fallback;
+        }
+    };
+
+    class JsonReader
+    {
+    public:
+        JsonReader(const std::string &text, const std::string &filepath) noexcept : m_text(text), m_filepath(filepath)
+        {
+        }
+
+        [[nodiscard]] JsonObject parse()
+        {
+            JsonObject root = parse_object();
+            skip_whitespace();
+            if (m_pos != m_text.size())
+                fail("trailing characters");
+            return root;
+        }
+
+    private:
+        const std::string &m_text;
+        const std::string &m_filepath;
+        size_t m_pos = 0;
+
+        [[noreturn]] void fail(const std::string &what) const
+        {
+            throw std::runtime_error(m_filepath + ": " + what + " at offset " + std::to_string(m_pos));
+        }
+
+        void skip_whitespace() noexcept
+        {
+            while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+                ++m_pos;
+        }
+
+        void expect(char c)
+        {
+            skip_whitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != c)
+                fail(std::string("expected '") + c + "'");
+            ++m_pos;
+        }
+
+        [[nodiscard]] std::string parse_string()
+        {
+            expect('"');
+            const size_t end = m_text.find('"', m_pos);
+            if (end == std::string::npos)
+                fail("unterminated string");
+            std::string value = m_text.substr(m_pos, end - m_pos);
+            m_pos = end + 1;
+            return value;
+        }
+
+        [[nodiscard]] JsonObject parse_object()
+        {
+            JsonObject object;
+            expect('{');
+            skip_whitespace();
+            if (m_pos < m_text.size() && m_text[m_pos] == '}')
+            {
+                ++m_pos;
+                return object;
+            }
+            while (true)
+            {
+                const std::string key = parse_string();
+                expect(':');
+                skip_whitespace();
+                if (m_pos < m_text.size() && m_text[m_pos] == '{')
+                    object.objects[key] = parse_object();
+                else
+                {
+                    const char *begin = m_text.c_str() + m_pos;
+                    char *end = nullptr;
+                    object.numbers[key] = std::strtod(begin, &end);
+                    if (end == begin)
+                        fail("expected a number or an object");
+                    m_pos += static_cast<size_t>(end - begin);
+                }
+                skip_whitespace();
+                if (m_pos < m_text.size() && m_text[m_pos] == ',')
+                {
+                    ++m_pos;
+                    continue;
+                }
+                expect('}');
+                return object;
+            }
+        }
+    };
+
+    [[nodiscard]] JsonObject read_baseline(const std::string &filepath)
+    {
+        std::ifstream in(filepath);
+        if (!in)
+            throw std::runtime_error("Could not open " + filepath);
+        std::ostringstream text;
+        text << in.rdbuf();
+        const std::string content = text.str();
+        return JsonReader(content, filepath).parse();
+    }
+
+    [[nodiscard]] Tolerance read_tolerance(const JsonObject &baseline) noexcept
+    {
+        Tolerance tolerance;
+        const JsonObject *table = baseline.find("tolerance");
+        if (table == nullptr)
+            return tolerance;
+        tolerance.time = table->find_or("time", tolerance.time);
+        tolerance.time_floor_us = table->find_or("time_floor_us", tolerance.time_floor_us);
+        tolerance.allocations = table->find_or("allocations", tolerance.allocations);
+        return tolerance;
+    }
+
+    /* Returns the number of regressions */
+    [[nodiscard]] size_t compare(const std::string &name, const PerfResult &result, const JsonObject &baseline, const Tolerance &tolerance)
+    {
+        const JsonObject *scenarios = baseline.find("scenarios");
+        const JsonObject *expected = scenarios != nullptr ? scenarios->find(name) : nullptr;
+        if (expected == nullptr)
+        {
+            std::cout << "  " << name << ": no baseline, run with --update" << std::endl;
+            return 1;
+        }
+
+        size_t regressions = 0;
+        const auto expected_allocations = static_cast<uint64_t>(expected->find_or("allocations", 0.0));
+        const bool allocations_regressed = result.allocations > expected_allocations * (1.0 + tolerance.allocations);
+        regressions += allocations_regressed;
+        std::cout << "  " << name << " allocations: " << result.allocations << " (baseline " << expected_allocations << ")"
+                  << (allocations_regressed ? " REGRESSION" : "") << std::endl;
+
+        const JsonObject *expected_median_us = expected->find("median_us");
+        for (const auto &[system, median_us] : result.median_us)
+        {
+            const double expected_us = expected_median_us != nullptr ? expected_median_us->find_or(system, 0.0) : 0.0;
+            const bool regressed = median_us > expected_us * (1.0 + tolerance.time) && median_us - expected_us > tolerance.time_floor_us;
+            regressions += regressed;
+            std::cout << "  " << name << " " << system << ": " << float_to_string(median_us, 2) << " us (baseline "
+                      << float_to_string(expected_us, 2) << " us)" << (regressed ? " REGRESSION" : "") << std::endl;
+        }
+        return regressions;
+    }
+
+    void write_baseline(const std::string &filepath, const Tolerance &tolerance, const std::map<std::string, PerfResult> &results)
+    {
+        std::ofstream out(filepath);
+        if (!out)
+            throw std::runtime_error("Could not open " + filepath);
+
+        out << std::fixed << std::setprecision(3) << "{\n  \"tolerance\": {\"time\": " << tolerance.time
+            << ", \"time_floor_us\": " << tolerance.time_floor_us << ", \"allocations\": " << tolerance.allocations
+            << "},\n  \"scenarios\": {\n";
+        size_t i = 0;
+        for (const auto &[name, result] : results)
+        {
+            out << "    \"" << name << "\": {\n      \"allocations\": " << result.allocations << ",\n      \"median_us\": {\n";
+            size_t j = 0;
+            for (const auto &[system, median_us] : result.median_us)
+                out << "        \"" << system << "\": " << median_us << (++j < result.median_us.size() ? ",\n" : "\n");
+            out << "      }\n    }" << (++i < results.size() ? ",\n" : "\n");
+        }
+        out << "  }\n}\n";
+    }
+
+    [[nodiscard]] PerfOptions parse_perf_cli(int argc, char *argv[])
+    {
+        PerfOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help")
+                options.show_help = true;
+            else if (arg == "--config")
+                options.config_filepath = bench::next_value(argc, argv, i);
+            else if (arg == "--baseline")
+                options.baseline_filepath = bench::next_value(argc, argv, i);
+            else if (arg == "--output")
+                options.output_filepath = bench::next_value(argc, argv, i);
+            else if (arg == "--scenarios")
+                options.scenario_dirpath = bench::next_value(argc, argv, i) + "/";
+            else if (arg == "--repetitions")
+                options.repetitions = std::max<size_t>(1, std::stoul(bench::next_value(argc, argv, i)));
+            else if (arg == "--update")
+                options.update = true;
+            else
+                throw std::runtime_error("Unknown option " + arg);
+        }
+        return options;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const PerfOptions options = parse_perf_cli(argc, argv);
+        if (options.show_help)
+        {
+            std::cout << "Usage: " << argv[0] << " [options]\n"
+                      << "  --config FILE              Configuration file (default ../resources/config.toml)\n"
+                      << "  --baseline FILE            Baseline to compare with (default ../bench/perf_baseline.json)\n"
+                      << "  --output FILE              Where --update writes the new baseline (default perf_baseline.json)\n"
+                      << "  --scenarios DIR            Scenario files (default ../resources/scenarios)\n"
+                      << "  --repetitions N            Runs per scenario, medians are taken over them (default 5)\n"
+                      << "  --update                   Record the current numbers as the baseline\n"
+                      << "  -h, --help                 Show this message\n";
+            return 0;
+        }
+
+        /* A missing baseline is only fine when creating one, its tolerances are kept otherwise */
+        JsonObject baseline;
+        if (std::ifstream(options.baseline_filepath))
+            baseline = read_baseline(options.baseline_filepath);
+        else if (!options.update)
+            throw std::runtime_error("Could not open " + options.baseline_filepath + ", create it with --update");
+        const Tolerance tolerance = read_tolerance(baseline);
+
+        std::map<std::string, PerfResult> results;
+        size_t regressions = 0;
+        for (const auto &scenario : perf_scenarios(options))
+        {
+            const PerfResult result = run_scenario(scenario, options);
+            results[scenario.name] = result;
+            if (!options.update)
+                regressions += compare(scenario.name, result, baseline, tolerance);
+        }
+
+        if (options.update)
+        {
+            write_baseline(options.output_filepath, tolerance, results);
+            std::cout << "Baseline written to " << options.output_filepath << ", copy it to bench/perf_baseline.json and commit it" << std::endl;
+            return 0;
+        }
+
+        std::cout << (regressions > 0 ? "FAILED: " + std::to_string(regressions) + " regressions" : "PASSED") << std::endl;
+        return regressions > 0 ? 1 : 0;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,27 @@
+#include <iostream>
+
+#include "batch_runner.hpp"
+#include "cli.hpp"
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const BatchCliOptions options = parse_batch_cli(argc, argv);
+        if (options.show_help)
+        {
+            print_batch_usage(argv[0]);
+            return 0;
+        }
+
+        BatchRunner runner(options);
+        runner.run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
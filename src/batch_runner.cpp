@@ -0,0 +1,121 @@
+#include "batch_runner.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include "game.hpp"
+#include "thread_pool.hpp"
+
+BatchRunner::BatchRunner(const BatchCliOptions &options) : m_options(options), m_output(options.output_filepath)
+{
+    if (!m_output)
+        throw std::runtime_error("Could not open " + options.output_filepath);
+
+    const std::string extension = ".json";
+    const auto &path = options.output_filepath;
+    m_json = path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+void BatchRunner::run()
+{
+    const auto start = std::chrono::steady_clock::now();
+    write_header();
+
+    {
+        ThreadPool pool(m_options.threads);
+        std::cout << "Running " << m_options.runs << " games on " << pool.size() << " threads" << std::endl;
+
+        for (uint64_t i = 0; i < m_options.runs; ++i)
+        {
+            const uint64_t seed = m_options.first_seed + i;
+            pool.submit([this, seed]
+                        { run_game(seed); });
+        }
+        pool.wait();
+    }
+
+    write_footer();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << m_written << " games in " << float_to_string(elapsed.count(), 2) << " s, "
+              << m_failed.load() << " failed, results in " << m_options.output_filepath << std::endl;
+}
+
+void BatchRunner::write_header()
+{
+    if (m_json)
+    {
+        m_output << "[\n";
+        return;
+    }
+
+    m_output << "seed,ticks,survival_ticks,deaths,score,highscore,peak_entities,peak_enemies,peak_bullets,wall_seconds";
+    for (const char *name : system_names)
+        m_output << ",avg_us_" << name;
+    m_output << '\n';
+}
+
+void BatchRunner::write_footer()
+{
+    if (m_json)
+        m_output << "\n]\n";
+}
+
+void BatchRunner::write_result(uint64_t seed, const RunStats &stats, double seconds)
+{
+    std::lock_guard lock(m_output_mutex);
+
+    if (m_json)
+    {
+        m_output << (m_written > 0 ? ",\n" : "")
+                 << "{\"seed\":" << seed << ",\"ticks\":" << stats.ticks << ",\"survival_ticks\":" << stats.survival_ticks
+                 << ",\"deaths\":" << stats.deaths << ",\"score\":" << stats.score << ",\"highscore\":" << stats.highscore
+                 << ",\"peak_entities\":" << stats.peak_entities << ",\"peak_enemies\":" << stats.peak_enemies
+                 << ",\"peak_bullets\":" << stats.peak_bullets << ",\"wall_seconds\":" << seconds << ",\"avg_us\":{";
+        for (size_t i = 0; i < system_names.size(); ++i)
+            m_output << (i > 0 ? "," : "") << '"' << system_names[i] << "\":" << stats.average_us(static_cast<SystemId>(i));
+        m_output << "}}";
+    }
+    else
+    {
+        m_output << seed << ',' << stats.ticks << ',' << stats.survival_ticks << ',' << stats.deaths << ','
+                 << stats.score << ',' << stats.highscore << ',' << stats.peak_entities << ','
+                 << stats.peak_enemies << ',' << stats.peak_bullets << ',' << seconds;
+        for (size_t i = 0; i < system_names.size(); ++i)
+            m_output << ',' << stats.average_us(static_cast<SystemId>(i));
+        m_output << '\n';
+    }
+
+    /* Stream results, a long batch can be inspected while it runs */
+    m_output.flush();
+    m_written++;
+}
+
+void BatchRunner::run_game(uint64_t seed) noexcept
+{
+    try
+    {
+        GameOptions options;
+        options.headless = true;
+        options.max_ticks = m_options.ticks;
+        options.seed = seed;
+        options.profile = false;
+        options.print_summary = false;
+        options.collect_stats = true;
+        options.stop_on_death = m_options.stop_on_death;
+        options.bot = m_options.bot;
+
+        const auto start = std::chrono::steady_clock::now();
+        Game game(m_options.config_filepath, options);
+        game.run();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        write_result(seed, game.stats(), elapsed.count());
+    }
+    catch (const std::exception &e)
+    {
+        m_failed++;
+        std::cerr << "Game with seed " << seed << " failed: " << e.what() << std::endl;
+    }
+}
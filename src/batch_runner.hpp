@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "cli.hpp"
+#include "run_stats.hpp"
+
+/* Runs seeded headless games on a thread pool and streams one result per game */
+class BatchRunner
+{
+public:
+    explicit BatchRunner(const BatchCliOptions &options);
+
+    void run();
+
+private:
+    BatchCliOptions m_options;
+    std::ofstream m_output;
+    bool m_json = false;
+
+    std::mutex m_output_mutex;
+    uint64_t m_written = 0;
+    std::atomic<uint64_t> m_failed = 0;
+
+    void write_header();
+    void write_footer();
+    void write_result(uint64_t seed, const RunStats &stats, double seconds);
+    void run_game(uint64_t seed) noexcept;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/*
+Tiny 5x7 bitmap font for renderers without font rasterization.
+Covers digits, letters (lowercase is drawn as uppercase), space and : . - / %
+Each glyph is 7 rows of 5 bits, the most significant bit is the leftmost pixel.
+*/
+namespace bitmap_font
+{
+    constexpr int glyph_width = 5;
+    constexpr int glyph_height = 7;
+    constexpr int advance = glyph_width + 1;      /* Horizontal distance between glyphs, in font pixels */
+    constexpr int line_height = glyph_height + 2; /* Vertical distance between lines, in font pixels */
+
+    using Glyph = std::array<uint8_t, glyph_height>;
+
+    namespace detail
+    {
+        constexpr std::array<Glyph, 10> digits = {{
+            {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},
+            {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},
+            {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},
+            {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},
+            {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},
+            {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
+            {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},
+            {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
+            {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},
+            {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
+        }};
+
+        constexpr std::array<Glyph, 26> letters = {{
+            {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}, // A
+            {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // B
+            {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // C
+            {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // D
+            {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // E
+            {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // F
+            {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // G
+            {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // H
+            {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // I
+            {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // J
+            {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+            {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // L
+            {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+            {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+            {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // O
+            {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // P
+            {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // Q
+            {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // R
+            {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // S
+            {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+            {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // U
+            {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // V
+            {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // W
+            {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // X
+            {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // Y
+            {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // Z
+        }};
+
+        constexpr Glyph blank = {0, 0, 0, 0, 0, 0, 0};
+        constexpr Glyph colon = {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00};
+        constexpr Glyph period = {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C};
+        constexpr Glyph minus = {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00};
+        constexpr Glyph slash = {0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x10};
+        constexpr Glyph percent = {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03};
+    }
+
+    /* Unknown characters are blank */
+    constexpr const Glyph &glyph(char c) noexcept
+    {
+        if (c >= '0' && c <= '9')
+            return detail::digits[c - '0'];
+        if (c >= 'A' && c <= 'Z')
+            return detail::letters[c - 'A'];
+        if (c >= 'a' && c <= 'z')
+            return detail::letters[c - 'a'];
+        switch (c)
+        {
+        case ':':
+            return detail::colon;
+        case '.':
+            return detail::period;
+        case '-':
+            return detail::minus;
+        case '/':
+            return detail::slash;
+        case '%':
+            return detail::percent;
+        default:
+            return detail::blank;
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#include "bot.hpp"
+
+#include <limits>
+
+#include "deterministic_math.hpp"
+
+Bot::Bot(BotPolicy policy, const sf::FloatRect &bounds, float bullet_speed, const Rng &rng) noexcept : m_policy(policy),
+                                                                                                        m_bounds(bounds),
+                                                                                                        m_bullet_speed(bullet_speed),
+                                                                                                        m_rng(rng)
+{
+}
+
+void Bot::update(CInput &input, const BotView &view) noexcept
+{
+    switch (m_policy)
+    {
+    case BotPolicy::Scripted:
+        update_scripted(input, view);
+        break;
+    case BotPolicy::Idle:
+        input = CInput();
+        input.exists = true;
+        break;
+    case BotPolicy::Random:
+        update_random(input, view);
+        break;
+    case BotPolicy::Aim:
+        update_aim(input, view);
+        break;
+    case BotPolicy::Kite:
+        update_kite(input, view);
+        break;
+    case BotPolicy::Berserk:
+        update_kite(input, view);
+        input.shoot = true;
+        input.ability = view.ability_ready;
+        break;
+    }
+}
+
+[[nodiscard]] BotPolicy Bot::policy() const noexcept
+{
+    return m_policy;
+}
+
+void Bot::update_scripted(CInput &input, const BotView &view) const noexcept
+{
+    /*
+    Deterministic pattern:
+    - Move along a square, changing direction every 90 ticks
+    - Aim sweeps around the player
+    - Shoot every 10 ticks, use the ability whenever it is ready
+    */
+    const uint64_t direction = (view.tick / 90) % 4;
+    input.up = direction == 0;
+    input.right = direction == 1;
+    input.down = direction == 2;
+    input.left = direction == 3;
+    input.shoot = view.tick % 10 == 0;
+    input.ability = true;
+
+    const float angle = 0.05f * static_cast<float>(view.tick);
+    input.aim = view.player_pos + 100.0f * sf::Vector2f{dmath::cos(angle), dmath::sin(angle)};
+}
+
+void Bot::update_random(CInput &input, const BotView &view) noexcept
+{
+    /* New decision every 15 ticks, held in between like a human would */
+    if (view.tick % 15 != 0)
+    {
+        input.shoot = false;
+        return;
+    }
+
+    const uint64_t value = m_rng.next();
+    input.up = value & 1;
+    input.down = value & 2;
+    input.left = value & 4;
+    input.right = value & 8;
+    input.shoot = value & 16;
+    input.ability = (value & 0xFF00) == 0;
+
+    const float xmax = m_bounds.position.x + m_bounds.size.x;
+    const float ymax = m_bounds.position.y + m_bounds.size.y;
+    input.aim = {m_rng.uniform(m_bounds.position.x, xmax), m_rng.uniform(m_bounds.position.y, ymax)};
+}
+
+void Bot::update_aim(CInput &input, const BotView &view) const noexcept
+{
+    set_direction(input, {0.0f, 0.0f});
+    input.ability = false;
+
+    const auto enemy = nearest_enemy(view);
+    input.shoot = enemy && view.tick % fire_interval == 0;
+    if (enemy)
+        input.aim = lead_target(*enemy, view.player_pos);
+}
+
+void Bot::update_kite(CInput &input, const BotView &view) const noexcept
+{
+    update_aim(input, view);
+
+    /* Flee the enemies in the danger radius, weighted by proximity, drift back to the center otherwise */
+    sf::Vector2f flee = {0.0f, 0.0f};
+    if (view.enemies)
+    {
+        for (const auto &enemy : *view.enemies)
+        {
+            if (!enemy->is_alive() || !enemy->has<CTransform>())
+                continue;
+
+            const sf::Vector2f away = view.player_pos - enemy->get<CTransform>().pos;
+            const float distance_sq = away.lengthSquared();
+            if (distance_sq > 0.0f && distance_sq < danger_radius * danger_radius)
+                flee += away / distance_sq;
+        }
+    }
+
+    const sf::Vector2f center = m_bounds.position + 0.5f * m_bounds.size;
+    if (flee.lengthSquared() > 0.0f)
+        set_direction(input, flee);
+    else if ((center - view.player_pos).lengthSquared() > danger_radius * danger_radius)
+        set_direction(input, center - view.player_pos);
+}
+
+[[nodiscard]] std::shared_ptr<Entity> Bot::nearest_enemy(const BotView &view) const noexcept
+{
+    if (!view.enemies)
+        return nullptr;
+
+    std::shared_ptr<Entity> nearest;
+    float nearest_distance_sq = std::numeric_limits<float>::max();
+    for (const auto &enemy : *view.enemies)
+    {
+        if (!enemy->is_alive() || !enemy->has<CTransform>())
+            continue;
+
+        const float distance_sq = (enemy->get<CTransform>().pos - view.player_pos).lengthSquared();
+        if (distance_sq < nearest_distance_sq)
+        {
+            nearest_distance_sq = distance_sq;
+            nearest = enemy;
+        }
+    }
+    return nearest;
+}
+
+[[nodiscard]] sf::Vector2f Bot::lead_target(const Entity &enemy, const sf::Vector2f &player_pos) const noexcept
+{
+    /* First order lead: where the enemy will be when a bullet covers the current distance */
+    const auto &transform = enemy.get<CTransform>();
+    if (m_bullet_speed <= 0.0f)
+        return transform.pos;
+
+    const float ticks = (transform.pos - player_pos).length() / m_bullet_speed;
+    return transform.pos + ticks * transform.velocity;
+}
+
+void Bot::set_direction(CInput &input, const sf::Vector2f &direction) noexcept
+{
+    /* Dead zone, so that diagonal moves only happen when both axes matter */
+    const float threshold = 0.38f * direction.length();
+    input.up = direction.y < -threshold;
+    input.down = direction.y > threshold;
+    input.left = direction.x < -threshold;
+    input.right = direction.x > threshold;
+}
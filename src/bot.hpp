@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+#include <SFML/Graphics.hpp>
+
+#include "entity_manager.hpp"
+#include "random.hpp"
+
+/* Behaviour of the built-in player controller */
+enum class BotPolicy
+{
+    Scripted, /* Deterministic movement and aim pattern */
+    Idle,     /* No input at all */
+    Random,   /* Random movement, aim and shots */
+    Aim,      /* Stands still, aims at the nearest enemy and shoots at a human rate */
+    Kite,     /* Aims at the nearest enemy while moving away from close ones */
+    Berserk   /* Kites, shoots every tick and uses the ability whenever it is ready */
+};
+
+constexpr std::array<const char *, 6> bot_policy_names = {"scripted", "idle", "random", "aim", "kite", "berserk"};
+
+[[nodiscard]] inline const char *to_string(BotPolicy policy) noexcept
+{
+    return bot_policy_names[static_cast<size_t>(policy)];
+}
+
+[[nodiscard]] inline BotPolicy bot_policy_from_string(const std::string &name)
+{
+    for (size_t i = 0; i < bot_policy_names.size(); ++i)
+    {
+        if (name == bot_policy_names[i])
+            return static_cast<BotPolicy>(i);
+    }
+    throw std::runtime_error("Unknown bot policy " + name);
+}
+
+/* What the bot sees of the world each tick */
+struct BotView
+{
+    sf::Vector2f player_pos = {0.0f, 0.0f};
+    const EntityVec *enemies = nullptr;
+    bool ability_ready = false;
+    uint64_t tick = 0;
+};
+
+/* AI controller filling CInput and the aim point, usable headless or in a window */
+class Bot
+{
+public:
+    Bot() noexcept = default;
+    Bot(BotPolicy policy, const sf::FloatRect &bounds, float bullet_speed, const Rng &rng) noexcept;
+
+    void update(CInput &input, const BotView &view) noexcept;
+    [[nodiscard]] BotPolicy policy() const noexcept;
+
+private:
+    BotPolicy m_policy = BotPolicy::Idle;
+    sf::FloatRect m_bounds;
+    float m_bullet_speed = 0.0f;
+    Rng m_rng;
+
+    /* Ticks between two shots outside of berserk mode, about a human click rate */
+    static constexpr uint64_t fire_interval = 6;
+    static constexpr float danger_radius = 200.0f;
+
+    void update_scripted(CInput &input, const BotView &view) const noexcept;
+    void update_random(CInput &input, const BotView &view) noexcept;
+    void update_aim(CInput &input, const BotView &view) const noexcept;
+    void update_kite(CInput &input, const BotView &view) const noexcept;
+
+    [[nodiscard]] std::shared_ptr<Entity> nearest_enemy(const BotView &view) const noexcept;
+    [[nodiscard]] sf::Vector2f lead_target(const Entity &enemy, const sf::Vector2f &player_pos) const noexcept;
+    static void set_direction(CInput &input, const sf::Vector2f &direction) noexcept;
+};
@@ -0,0 +1,252 @@
+#include "cli.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    [[nodiscard]] std::string next_value(int argc, char *argv[], int &i)
+    {
+        if (i + 1 >= argc)
+            throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        return argv[++i];
+    }
+
+    [[nodiscard]] uint64_t to_u64(const std::string &value, const std::string &option)
+    {
+        try
+        {
+            size_t read = 0;
+            const auto result = std::stoull(value, &read);
+            if (read == value.size())
+                return result;
+        }
+        catch (const std::exception &)
+        {
+        }
+        throw std::runtime_error("Invalid value '" + value + "' for " + option);
+    }
+}
+
+[[nodiscard]] CliOptions parse_cli(int argc, char *argv[])
+{
+    CliOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help")
+        {
+            options.show_help = true;
+        }
+        else if (arg == "--config")
+        {
+            options.config_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--headless")
+        {
+            options.headless = true;
+        }
+        else if (arg == "--ticks")
+        {
+            options.ticks = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--bot")
+        {
+            options.bot = bot_policy_from_string(next_value(argc, argv, i));
+        }
+        else if (arg == "--seed")
+        {
+            options.seed = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--record")
+        {
+            options.record_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--replay")
+        {
+            options.replay_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--keyframe-interval")
+        {
+            options.keyframe_interval = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--seek")
+        {
+            options.seek_tick = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--hash-log")
+        {
+            options.hash_log_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--hash-check")
+        {
+            options.hash_check_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--scenario")
+        {
+            options.scenario_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--renderer")
+        {
+            options.renderer = renderer_kind_from_string(next_value(argc, argv, i));
+        }
+        else if (arg == "--render-threads")
+        {
+            options.render_threads = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--dump-frames")
+        {
+            options.frame_dump_dirpath = next_value(argc, argv, i);
+        }
+        else if (arg == "--dump-interval")
+        {
+            options.frame_dump_interval = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--pacing-histogram")
+        {
+            options.pacing_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--trace")
+        {
+            options.trace_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--trace-frames")
+        {
+            /* FIRST:COUNT or COUNT */
+            const std::string value = next_value(argc, argv, i);
+            const size_t colon = value.find(':');
+            if (colon == std::string::npos)
+            {
+                options.trace_frame_count = to_u64(value, arg);
+            }
+            else
+            {
+                options.trace_first_frame = to_u64(value.substr(0, colon), arg);
+                options.trace_frame_count = to_u64(value.substr(colon + 1), arg);
+            }
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option " + arg);
+        }
+    }
+
+    if (options.frame_dump_interval == 0)
+        throw std::runtime_error("--dump-interval must be greater than 0");
+
+    /* Nothing closes a headless run, it must end on its own */
+    if (options.headless && options.ticks == 0 && options.replay_filepath.empty() && options.scenario_filepath.empty())
+        throw std::runtime_error("--headless needs --ticks, --replay or --scenario to end");
+
+    /* Only the offscreen renderer keeps its frames */
+    if (!options.frame_dump_dirpath.empty())
+    {
+        if (options.renderer.value_or(RendererKind::Software) != RendererKind::Software)
+            throw std::runtime_error("--dump-frames needs the software renderer");
+        options.renderer = RendererKind::Software;
+    }
+
+    return options;
+}
+
+void print_usage(const char *program) noexcept
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --config FILE              Configuration file (default ../resources/config.toml)\n"
+              << "  --headless                 Run the simulation without a window, with scripted input\n"
+              << "  --ticks N                  Stop after N ticks (default 0: run until closed, required by --headless\n"
+              << "                             without --replay or --scenario)\n"
+              << "  --bot POLICY               Bot playing instead of the mouse and keyboard:\n"
+              << "                             scripted, idle, random, aim, kite, berserk (headless default: scripted)\n"
+              << "  --seed N                   Seed of the random streams (default: config seed)\n"
+              << "  --record FILE              Record the seed and the input of every tick\n"
+              << "  --replay FILE              Replay a recorded run, replacing the input\n"
+              << "  --keyframe-interval K      Ticks between two world snapshots in recordings (default 600, 0: none)\n"
+              << "  --seek N                   Start the replay at tick N from the nearest snapshot\n"
+              << "  --hash-log FILE            Write the world state hash of every tick (- for stdout)\n"
+              << "  --hash-check FILE          Stop at the first tick whose hash differs from a hash log\n"
+              << "  --scenario FILE            Stress scenario, reports frame time against entity count\n"
+              << "  --renderer NAME            Render backend: null, sfml, software (default: sfml, headless: null)\n"
+              << "  --render-threads N         Vertex generation and software renderer threads (default 0: all hardware threads)\n"
+              << "  --dump-frames DIR          Write software rendered frames to DIR/tick_N.ppm (implies --renderer software)\n"
+              << "  --dump-interval N          Ticks between two dumped frames (default 1)\n"
+              << "  --pacing-histogram FILE    Write the frame time and pacing error histograms of a windowed run as CSV\n"
+              << "  --trace FILE               Write a Chrome trace_event JSON file on exit\n"
+              << "  --trace-frames [FIRST:]N   Frames recorded in the trace (default 0:600)\n"
+              << "  -h, --help                 Show this message\n";
+}
+
+[[nodiscard]] BatchCliOptions parse_batch_cli(int argc, char *argv[])
+{
+    BatchCliOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help")
+        {
+            options.show_help = true;
+        }
+        else if (arg == "--config")
+        {
+            options.config_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--output")
+        {
+            options.output_filepath = next_value(argc, argv, i);
+        }
+        else if (arg == "--runs")
+        {
+            options.runs = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--seed")
+        {
+            options.first_seed = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--ticks")
+        {
+            options.ticks = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--threads")
+        {
+            options.threads = to_u64(next_value(argc, argv, i), arg);
+        }
+        else if (arg == "--bot")
+        {
+            options.bot = bot_policy_from_string(next_value(argc, argv, i));
+        }
+        else if (arg == "--continue-after-death")
+        {
+            options.stop_on_death = false;
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option " + arg);
+        }
+    }
+
+    if (options.first_seed == 0)
+        throw std::runtime_error("--seed must be greater than 0");
+    if (options.ticks == 0)
+        throw std::runtime_error("--ticks must be greater than 0");
+
+    return options;
+}
+
+void print_batch_usage(const char *program) noexcept
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --config FILE              Configuration file (default ../resources/config.toml)\n"
+              << "  --output FILE              Results, JSON if FILE ends with .json, CSV otherwise (default batch_results.csv)\n"
+              << "  --runs N                   Number of games (default 100)\n"
+              << "  --seed N                   Seed of the first game, game i uses N + i (default 1)\n"
+              << "  --ticks N                  Tick limit of each game (default 36000)\n"
+              << "  --threads N                Worker threads (default 0: all hardware threads)\n"
+              << "  --bot POLICY               Player input: scripted, idle, random, aim, kite, berserk\n"
+              << "                             (default scripted)\n"
+              << "  --continue-after-death     Play until the tick limit instead of stopping at the first death\n"
+              << "  -h, --help                 Show this message\n";
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <optional>
+
+#include "bot.hpp"
+#include "renderer.hpp"
+
+struct CliOptions
+{
+    std::string config_filepath = "../resources/config.toml";
+
+    /* Headless simulation, no window */
+    bool headless = false;
+    uint64_t ticks = 0;
+    std::optional<BotPolicy> bot;
+
+    /* Determinism */
+    uint64_t seed = 0;
+    std::string record_filepath = "";
+    std::string replay_filepath = "";
+    uint64_t keyframe_interval = 600;
+    uint64_t seek_tick = 0;
+    std::string hash_log_filepath = "";
+    std::string hash_check_filepath = "";
+
+    /* Stress scenario, disabled when no filepath is given */
+    std::string scenario_filepath = "";
+
+    /* Render backend and golden-image frame dumps */
+    std::optional<RendererKind> renderer;
+    uint64_t render_threads = 0;
+    std::string frame_dump_dirpath = "";
+    uint64_t frame_dump_interval = 1;
+
+    /* Frame pacing histograms, disabled when no filepath is given */
+    std::string pacing_filepath = "";
+
+    /* Chrome trace export, disabled when no filepath is given */
+    std::string trace_filepath = "";
+    uint64_t trace_first_frame = 0;
+    uint64_t trace_frame_count = 600;
+
+    bool show_help = false;
+};
+
+struct BatchCliOptions
+{
+    std::string config_filepath = "../resources/config.toml";
+    std::string output_filepath = "batch_results.csv"; /* .json for JSON, CSV otherwise */
+    uint64_t runs = 100;
+    uint64_t first_seed = 1; /* Run i uses seed first_seed + i */
+    uint64_t ticks = 36000;  /* Tick limit of each run */
+    uint64_t threads = 0;    /* 0 uses every hardware thread */
+    BotPolicy bot = BotPolicy::Scripted;
+    bool stop_on_death = true;
+    bool show_help = false;
+};
+
+[[nodiscard]] CliOptions parse_cli(int argc, char *argv[]);
+void print_usage(const char *program) noexcept;
+
+[[nodiscard]] BatchCliOptions parse_batch_cli(int argc, char *argv[]);
+void print_batch_usage(const char *program) noexcept;
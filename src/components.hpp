@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <SFML/Graphics.hpp>
 
 struct Component
@@ -41,6 +43,7 @@ struct CInput : public Component
     bool right = false;
     bool shoot = false;
     bool ability = false;
+    sf::Vector2f aim = {0.0f, 0.0f}; /* World position the player aims at */
 
     CInput() noexcept = default;
 };
@@ -65,15 +68,20 @@ struct CScore : public Component
     }
 };
 
+/* Plain data, the geometry is produced by the renderer from the unit polygon table */
 struct CShape : public Component
 {
-    sf::CircleShape circle;
+    float radius = 0.0f;
+    uint32_t points = 0; /* Number of sides */
+    sf::Color fill_color = sf::Color::White;
+    sf::Color outline_color = sf::Color::Transparent;
+    float outline_thickness = 0.0f;
+    float rotation = 0.0f; /* Degrees, advanced by the renderer */
 
     CShape() noexcept = default;
-    CShape(float radius, size_t points, const sf::Color &color) noexcept : circle(radius)
+    CShape(float r, size_t p, const sf::Color &color) noexcept : radius(r),
+                                                                 points(static_cast<uint32_t>(p)),
+                                                                 fill_color(color)
     {
-        circle.setPointCount(points);
-        circle.setFillColor(color);
-        circle.setOrigin({radius, radius});
     }
-};
\ No newline at end of file
+};
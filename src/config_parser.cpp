@@ -9,6 +9,8 @@ ConfigParser::ConfigParser(const std::string &config_filepath) : m_filepath(conf
     m_bullet_config = parse_bullet(data);
     m_score_config = parse_score(data);
     m_ability_config = parse_ability(data);
+    m_random_config = parse_random(data);
+    m_render_config = parse_render(data);
 }
 
 const WindowConfig &ConfigParser::get_window_config() const noexcept
@@ -41,6 +43,16 @@ const AbilityConfig &ConfigParser::get_ability_config() const noexcept
     return m_ability_config;
 }
 
+const RandomConfig &ConfigParser::get_random_config() const noexcept
+{
+    return m_random_config;
+}
+
+const RenderConfig &ConfigParser::get_render_config() const noexcept
+{
+    return m_render_config;
+}
+
 template <typename T>
 [[nodiscard]] T ConfigParser::parse_section(const toml::value &data, const std::string &section_name)
 {
@@ -77,3 +89,25 @@ template <typename T>
 {
     return parse_section<AbilityConfig>(data, "ability");
 }
+
+[[nodiscard]] RandomConfig ConfigParser::parse_random(const toml::value &data)
+{
+    RandomConfig config;
+    if (!data.contains("random"))
+        return config;
+    const auto &random = toml::find(data, "random");
+    config.seed = toml::find_or<uint64_t>(random, "seed", config.seed);
+    return config;
+}
+
+[[nodiscard]] RenderConfig ConfigParser::parse_render(const toml::value &data)
+{
+    RenderConfig config;
+    if (!data.contains("render"))
+        return config;
+
+    const auto &render = toml::find(data, "render");
+    config.lod_tolerance = toml::find_or<float>(render, "lod_tolerance", config.lod_tolerance);
+    config.frame_budget = toml::find_or<float>(render, "frame_budget", config.frame_budget);
+    return config;
+}
@@ -18,6 +18,8 @@ public:
     const BulletConfig &get_bullet_config() const noexcept;
     const ScoreConfig &get_score_config() const noexcept;
     const AbilityConfig &get_ability_config() const noexcept;
+    const RandomConfig &get_random_config() const noexcept;
+    const RenderConfig &get_render_config() const noexcept;
 
 private:
     std::string m_filepath;
@@ -28,6 +30,8 @@ private:
     BulletConfig m_bullet_config;
     ScoreConfig m_score_config;
     AbilityConfig m_ability_config;
+    RandomConfig m_random_config;
+    RenderConfig m_render_config;
 
     template <typename T>
     [[nodiscard]] static T parse_section(const toml::value &data, const std::string &section_name);
@@ -38,4 +42,6 @@ private:
     [[nodiscard]] static BulletConfig parse_bullet(const toml::value &data);
     [[nodiscard]] static ScoreConfig parse_score(const toml::value &data);
     [[nodiscard]] static AbilityConfig parse_ability(const toml::value &data);
+    [[nodiscard]] static RandomConfig parse_random(const toml::value &data);
+    [[nodiscard]] static RenderConfig parse_render(const toml::value &data);
 };
@@ -65,3 +65,15 @@ struct AbilityConfig
     std::array<uint8_t, 4> color = {0, 0, 0, 255};
 };
 TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(AbilityConfig, duration, cooldown, color)
+
+/* Optional section, every field has a default */
+struct RenderConfig
+{
+    float lod_tolerance = 0.5f; /* Largest gap in pixels between a circle and the polygon drawn for it, 0 draws every side */
+    float frame_budget = 0.0f;  /* CPU ms per frame before circles lose more sides, 0 follows the framerate */
+};
+
+struct RandomConfig
+{
+    uint64_t seed = 0;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include <SFML/Graphics.hpp>
+
+#include "misc.hpp"
+
+/*
+Trigonometry used by the simulation.
+With GW_DETERMINISTIC_MATH (CMake option of the same name), results only depend on IEEE
+basic operations: sin / cos come from a table built at compile time, and the build disables
+FMA contraction, so replays and state hashes are bit-identical across compilers and CPUs.
+Otherwise the standard library functions are used.
+*/
+namespace dmath
+{
+    /* Divisible by every side count from 3 to 10, so polygon directions are exact table entries */
+    constexpr size_t table_size = 2520;
+
+    namespace detail
+    {
+        constexpr double pi = 3.14159265358979323846;
+
+        /* Taylor series on [-pi, pi], evaluated by the compiler in IEEE double */
+        constexpr double sin_series(double x) noexcept
+        {
+            double term = x;
+            double sum = x;
+            for (int i = 1; i < 30; ++i)
+            {
+                term *= -x * x / ((2.0 * i) * (2.0 * i + 1.0));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr std::array<float, table_size> make_sin_table() noexcept
+        {
+            std::array<float, table_size> table{};
+            for (size_t i = 0; i < table_size; ++i)
+            {
+                double angle = 2.0 * pi * static_cast<double>(i) / static_cast<double>(table_size);
+                if (angle > pi)
+                    angle -= 2.0 * pi;
+                table[i] = static_cast<float>(sin_series(angle));
+            }
+            return table;
+        }
+
+        inline constexpr std::array<float, table_size> sin_table = make_sin_table();
+
+        /* Table value at a fractional index, linearly interpolated */
+        inline float lookup(float turns) noexcept
+        {
+            const float t = (turns - std::floor(turns)) * static_cast<float>(table_size);
+            const size_t i = static_cast<size_t>(t) % table_size;
+            const float f = t - std::floor(t);
+            const float a = sin_table[i];
+            const float b = sin_table[(i + 1) % table_size];
+            return a + (b - a) * f;
+        }
+    }
+
+#ifdef GW_DETERMINISTIC_MATH
+    inline float sin(float radians) noexcept
+    {
+        return detail::lookup(radians / static_cast<float>(2.0 * detail::pi));
+    }
+
+    inline float cos(float radians) noexcept
+    {
+        return detail::lookup(radians / static_cast<float>(2.0 * detail::pi) + 0.25f);
+    }
+#else
+    inline float sin(float radians) noexcept
+    {
+        return std::sin(radians);
+    }
+
+    inline float cos(float radians) noexcept
+    {
+        return std::cos(radians);
+    }
+#endif
+}
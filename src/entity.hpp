@@ -2,6 +2,7 @@
 
 #include <tuple>
 #include <string>
+#include <type_traits>
 
 #include "components.hpp"
 
@@ -47,6 +48,10 @@ private:
     Entity &operator=(Entity &&) noexcept = delete;
 };
 
+/* Every system walks entities, keep them small: components are plain data */
+static_assert(std::is_trivially_copyable_v<CShape>, "CShape must stay plain data");
+static_assert(sizeof(Entity) <= 160, "Entity grew, check the component sizes");
+
 /* TEMPLATE FUNCTIONS HERE */
 
 template <typename T, typename... Args>
@@ -7,6 +7,13 @@
     return e;
 }
 
+[[nodiscard]] std::shared_ptr<Entity> EntityManager::restore_entity(const std::string &tag, size_t id) noexcept
+{
+    const auto e = std::shared_ptr<Entity>(new Entity(tag, id));
+    m_entities_to_add.push_back(e);
+    return e;
+}
+
 [[nodiscard]] EntityVec &EntityManager::get_entities() noexcept
 {
     return m_entities;
@@ -14,10 +21,11 @@
 
 [[nodiscard]] EntityVec &EntityManager::get_entities(const std::string &tag) noexcept
 {
-    static EntityVec empty;
-    if (m_entity_map.find(tag) != m_entity_map.end())
-        return m_entity_map.at(tag);
-    return empty;
+    const auto it = m_entity_map.find(tag);
+    if (it != m_entity_map.end())
+        return it->second;
+    m_empty.clear();
+    return m_empty;
 }
 
 void EntityManager::update() noexcept
@@ -40,6 +48,24 @@ void EntityManager::update() noexcept
     }
 }
 
+void EntityManager::clear(size_t total_entities) noexcept
+{
+    m_entities.clear();
+    m_entities_to_add.clear();
+    m_entity_map.clear();
+    m_total_entities = total_entities;
+}
+
+[[nodiscard]] const EntityVec &EntityManager::get_pending_entities() const noexcept
+{
+    return m_entities_to_add;
+}
+
+[[nodiscard]] size_t EntityManager::total_entities() const noexcept
+{
+    return m_total_entities;
+}
+
 void EntityManager::remove_dead_entities(EntityVec &vec) noexcept
 {
     vec.erase(std::remove_if(vec.begin(), vec.end(),
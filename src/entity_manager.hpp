@@ -22,14 +22,19 @@ public:
     EntityManager &operator=(EntityManager &&) noexcept = default;
 
     [[nodiscard]] std::shared_ptr<Entity> add_entity(const std::string &tag) noexcept;
+    [[nodiscard]] std::shared_ptr<Entity> restore_entity(const std::string &tag, size_t id) noexcept;
     [[nodiscard]] EntityVec &get_entities() noexcept;
     [[nodiscard]] EntityVec &get_entities(const std::string &tag) noexcept;
+    [[nodiscard]] const EntityVec &get_pending_entities() const noexcept; /* Added since the last update */
     void update() noexcept;
+    void clear(size_t total_entities = 0) noexcept;
+    [[nodiscard]] size_t total_entities() const noexcept;
 
 private:
     EntityVec m_entities;
     EntityVec m_entities_to_add;
     EntityMap m_entity_map;
+    EntityVec m_empty; /* Returned for unknown tags */
     size_t m_total_entities = 0;
 
     void remove_dead_entities(EntityVec &vec) noexcept;
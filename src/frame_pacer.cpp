@@ -0,0 +1,114 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "misc.hpp"
+#include "profiler.hpp"
+
+FramePacer::FramePacer() noexcept : FramePacer(0)
+{
+}
+
+FramePacer::FramePacer(unsigned framerate) noexcept : m_framerate(framerate),
+                                                      m_frame_times(0.25, 400),
+                                                      m_pacing_errors(10.0, 500)
+{
+    if (m_framerate > 0)
+        m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_framerate));
+}
+
+void FramePacer::wait() noexcept
+{
+    Clock::time_point now = Clock::now();
+    if (!m_started)
+    {
+        m_started = true;
+        m_deadline = now + m_period;
+        m_last_frame = now;
+        return;
+    }
+
+    if (m_framerate > 0)
+    {
+        PROFILE_ZONE("FramePacer::wait");
+
+        if (now < m_deadline)
+        {
+            /* Coarse sleep, its overshoot feeds the margin of the next frames */
+            const Clock::duration sleep = m_deadline - now - m_sleep_margin;
+            if (sleep > Clock::duration::zero())
+            {
+                std::this_thread::sleep_for(sleep);
+                const Clock::duration oversleep = Clock::now() - now - sleep;
+                m_oversleep = (7 * m_oversleep + oversleep) / 8;
+                m_sleep_margin = std::clamp(2 * m_oversleep, min_margin, max_margin);
+            }
+
+            /* Precise remainder */
+            while ((now = Clock::now()) < m_deadline)
+            {
+            }
+            m_pacing_errors.add(std::chrono::duration<double, std::micro>(now - m_deadline).count());
+            m_deadline += m_period;
+        }
+        else
+        {
+            /* Late frame: no burst of short frames to catch up, the cadence restarts from now */
+            m_missed_frames++;
+            m_pacing_errors.add(std::chrono::duration<double, std::micro>(now - m_deadline).count());
+            m_deadline = now + m_period;
+        }
+    }
+
+    m_frame_times.add(std::chrono::duration<double, std::milli>(now - m_last_frame).count());
+    m_last_frame = now;
+}
+
+void FramePacer::restart() noexcept
+{
+    m_started = false;
+}
+
+[[nodiscard]] const Histogram &FramePacer::frame_times() const noexcept
+{
+    return m_frame_times;
+}
+
+[[nodiscard]] const Histogram &FramePacer::pacing_errors() const noexcept
+{
+    return m_pacing_errors;
+}
+
+[[nodiscard]] uint64_t FramePacer::missed_frames() const noexcept
+{
+    return m_missed_frames;
+}
+
+[[nodiscard]] unsigned FramePacer::framerate() const noexcept
+{
+    return m_framerate;
+}
+
+void FramePacer::write_csv(const std::string &filepath) const
+{
+    std::ofstream out(filepath);
+    if (!out)
+        throw std::runtime_error("Could not write " + filepath);
+
+    out << "histogram,bucket_start,bucket_end,count\n";
+    m_frame_times.write_csv(out, "frame_time_ms");
+    m_pacing_errors.write_csv(out, "pacing_error_us");
+}
+
+void FramePacer::print_summary() const noexcept
+{
+    std::cout << "Frame pacing: " << m_frame_times.count() << " frames at " << m_framerate << " fps, frame time p50 "
+              << float_to_string(m_frame_times.percentile(50.0), 2) << " ms, p99 " << float_to_string(m_frame_times.percentile(99.0), 2)
+              << " ms, max " << float_to_string(m_frame_times.max(), 2) << " ms | pacing error p50 "
+              << float_to_string(m_pacing_errors.percentile(50.0), 0) << " us, p99 " << float_to_string(m_pacing_errors.percentile(99.0), 0)
+              << " us, max " << float_to_string(m_pacing_errors.max(), 0) << " us | " << m_missed_frames << " missed" << std::endl;
+}
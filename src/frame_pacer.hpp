@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "histogram.hpp"
+
+/*
+Holds the frame rate with a fixed cadence of deadlines.
+wait() sleeps until shortly before the deadline, then spin-waits the remainder: the OS sleep alone
+wakes up late by up to a scheduler tick. The sleep margin follows the measured oversleep.
+Frame times (start to start, ms) and pacing errors (wake up after the deadline, us) are kept in histograms.
+*/
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer() noexcept;
+
+    /* 0 disables the waiting, frame times are still measured */
+    explicit FramePacer(unsigned framerate) noexcept;
+
+    /* Called once per frame, after the frame is presented */
+    void wait() noexcept;
+
+    /* Drops the cadence after a pause, the next wait() starts a new one and is not measured */
+    void restart() noexcept;
+
+    [[nodiscard]] const Histogram &frame_times() const noexcept;
+    [[nodiscard]] const Histogram &pacing_errors() const noexcept;
+    [[nodiscard]] uint64_t missed_frames() const noexcept;
+    [[nodiscard]] unsigned framerate() const noexcept;
+
+    /* Both histograms as "histogram,bucket_start,bucket_end,count" */
+    void write_csv(const std::string &filepath) const;
+    void print_summary() const noexcept;
+
+private:
+    static constexpr Clock::duration min_margin = std::chrono::microseconds(200);
+    static constexpr Clock::duration max_margin = std::chrono::milliseconds(4);
+
+    unsigned m_framerate = 0;
+    Clock::duration m_period = Clock::duration::zero();
+    Clock::time_point m_deadline;
+    Clock::time_point m_last_frame;
+    bool m_started = false;
+
+    Clock::duration m_sleep_margin = std::chrono::milliseconds(1); /* Sleep stops this long before the deadline */
+    Clock::duration m_oversleep = Clock::duration::zero();         /* Moving average of the sleep overshoot */
+
+    Histogram m_frame_times;
+    Histogram m_pacing_errors;
+    uint64_t m_missed_frames = 0;
+};
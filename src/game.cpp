@@ -1,10 +1,34 @@
+#include <filesystem>
+#include <random>
+
 #include "game.hpp"
+#include "profiler.hpp"
+#include "sfml_renderer.hpp"
+#include "software_renderer.hpp"
+#include "state_hash.hpp"
+#include "polygon_table.hpp"
 
-// Randomizer
-std::random_device Game::m_rd;
-std::mt19937 Game::m_gen(Game::m_rd());
+namespace
+{
+    /* Random stream ids */
+    constexpr uint64_t spawn_stream = 1;
+    constexpr uint64_t bot_stream = 2;
+
+    /* Longest block in waitEvent while idle */
+    const sf::Time idle_timeout = sf::milliseconds(250);
+
+    /* HUD lines of the draw list */
+    constexpr size_t score_line = 0;
+    constexpr size_t ability_line = 1;
+    constexpr size_t pause_line = 2;
+    constexpr size_t hud_capacity = 64; /* Characters per line, reserved once */
+
+    /* ability_hud_value special values, cooldowns are in tenths of seconds */
+    constexpr int ability_ready = -1;
+    constexpr int ability_in_use = -2;
+}
 
-Game::Game(const std::string &config_filepath) : m_score_text(m_font), m_pause_text(m_font), m_cooldown_text(m_font)
+Game::Game(const std::string &config_filepath, const GameOptions &options) : m_options(options)
 {
     ConfigParser parser(config_filepath);
     m_window_config = parser.get_window_config();
@@ -13,87 +37,356 @@ Game::Game(const std::string &config_filepath) : m_score_text(m_font), m_pause_t
     m_bullet_config = parser.get_bullet_config();
     m_score_config = parser.get_score_config();
     m_ability_config = parser.get_ability_config();
+    m_render_config = parser.get_render_config();
+
+    /* A replay brings its own seed */
+    if (!m_options.replay_filepath.empty())
+    {
+        m_replay_reader = std::make_unique<ReplayReader>(m_options.replay_filepath);
+        m_seed = m_replay_reader->seed();
+    }
+    else if (m_options.seed != 0)
+    {
+        m_seed = m_options.seed;
+    }
+    else if (parser.get_random_config().seed != 0)
+    {
+        m_seed = parser.get_random_config().seed;
+    }
+    else
+    {
+        std::random_device rd;
+        m_seed = static_cast<uint64_t>(rd()) << 32 | rd();
+    }
+    m_spawn_rng = Rng(m_seed, spawn_stream);
+
+    if (!m_options.record_filepath.empty())
+        m_replay_writer = std::make_unique<ReplayWriter>(m_options.record_filepath, m_seed, m_options.keyframe_interval);
+
+    if (m_options.hash_log_filepath == "-")
+    {
+        m_hash_log = &std::cout;
+    }
+    else if (!m_options.hash_log_filepath.empty())
+    {
+        m_hash_log_file.open(m_options.hash_log_filepath);
+        if (!m_hash_log_file)
+            throw std::runtime_error("Could not open " + m_options.hash_log_filepath);
+        m_hash_log = &m_hash_log_file;
+    }
+
+    if (!m_options.hash_check_filepath.empty())
+    {
+        m_hash_check.open(m_options.hash_check_filepath);
+        if (!m_hash_check)
+            throw std::runtime_error("Could not open " + m_options.hash_check_filepath);
+    }
+
+    if (!m_options.scenario_filepath.empty())
+    {
+        m_scenario = std::make_unique<Scenario>(load_scenario(m_options.scenario_filepath), m_options.print_summary);
+        m_options.collect_stats = true;
+        if (m_options.max_ticks == 0)
+            m_options.max_ticks = m_scenario->config().max_ticks;
+        if (m_options.headless && m_options.max_ticks == 0 && m_scenario->config().targets.empty())
+            throw std::runtime_error(m_options.scenario_filepath + " has no targets nor max_ticks, a headless run needs one or --ticks to end");
+        if (!m_options.bot)
+            m_options.bot = m_scenario->config().bot;
+    }
 
     init();
+
+    if (m_options.headless && !m_options.bot)
+        m_options.bot = BotPolicy::Scripted;
+    if (m_options.bot)
+        m_bot = Bot(*m_options.bot, m_bounds, m_bullet_config.speed, Rng(m_seed, bot_stream));
+
+    if (m_replay_reader && m_options.seek_tick > 0)
+        seek(m_options.seek_tick);
 }
 
 void Game::run() noexcept
 {
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t start_tick = m_tick;
+    m_last_poll = start;
+
     while (m_running)
     {
-        m_entities.update();
+        if (m_options.profile)
+            Profiler::instance().begin_frame(m_frame);
+        m_frame++;
+        PROFILE_ZONE("frame");
+        m_frame_start = std::chrono::steady_clock::now();
 
-        while (const std::optional event = m_window.pollEvent())
         {
-            if (event->is<sf::Event::Closed>())
+            PROFILE_ZONE("EntityManager::update");
+            SystemTimer timer(stats_sink(), SystemId::EntityUpdate);
+            m_entities.update();
+        }
+
+        if (!m_options.headless)
+        {
+            PROFILE_ZONE("poll_events");
+
+            /* Idle: the last frame is on screen, sleep in the event queue until something happens */
+            if (m_idle_frame_presented)
             {
-                m_running = false;
+                if (const std::optional event = m_window.waitEvent(idle_timeout))
+                {
+                    /* The event woke the wait, it arrived now */
+                    m_last_poll = std::chrono::steady_clock::now();
+                    handle_event(event);
+                }
             }
 
-            system_user_input(event);
+            while (const std::optional event = m_window.pollEvent())
+                handle_event(event);
+            m_last_poll = std::chrono::steady_clock::now();
+
+            /* Nothing a paused game does answers a press */
+            if (m_paused)
+                m_latency.drop_pending();
         }
 
+        if (m_options.bot && !m_replay_reader && !m_paused)
+            system_bot_input();
+
+        /* Aim is latched last, right before the tick consumes it */
+        if (!m_options.headless && !m_options.bot)
+            system_mouse_aim();
+
         if (!m_paused)
+            step();
+
+        /* One frame is presented when going idle, none after it */
+        const bool idle = is_idle();
+        if (!idle || !m_idle_frame_presented)
+        {
+            SystemTimer timer(stats_sink(), SystemId::Render);
+            system_render();
+        }
+        m_idle_frame_presented = idle;
+
+        if (m_scenario && !m_paused)
+        {
+            const auto frame_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_frame_start).count();
+            m_scenario->sample(m_tick, m_entities.get_entities().size(), m_entities.get_entities("enemy").size(),
+                               m_entities.get_entities("bullet").size(), frame_ns, m_stats);
+            if (m_scenario->finished())
+                m_running = false;
+        }
+
+        if (m_options.max_ticks > 0 && m_tick >= m_options.max_ticks)
+            m_running = false;
+
+        if (!m_options.headless)
+        {
+            if (idle)
+                m_pacer.restart();
+            else
+                m_pacer.wait();
+        }
+    }
+
+    m_stats.ticks = m_tick;
+    m_stats.highscore = m_highscore;
+    m_stats.vertices_saved = m_lod.total_vertices_saved();
+    if (m_stats.deaths == 0)
+    {
+        m_stats.survival_ticks = m_tick;
+        m_stats.score = m_score;
+    }
+
+    if (m_options.headless && m_options.print_summary)
+    {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const uint64_t ticks = m_tick - start_tick;
+        std::cout << "Headless run: " << ticks << " ticks in " << float_to_string(elapsed.count(), 3) << " s ("
+                  << float_to_string(ticks / elapsed.count(), 1) << " ticks/s), tick " << m_tick << ", score " << m_score
+                  << ", highscore " << m_highscore << ", seed " << m_seed
+                  << ", state hash " << std::hex << compute_state_hash() << std::dec << std::endl;
+    }
+
+    if (m_stats.vertices > 0 && m_options.print_summary)
+    {
+        const double saved = static_cast<double>(m_stats.vertices_saved);
+        std::cout << "Rendered " << m_stats.vertices << " vertices, " << m_stats.vertices_saved << " saved by the level of detail ("
+                  << float_to_string(100.0 * saved / (saved + static_cast<double>(m_stats.vertices)), 1) << " %)" << std::endl;
+    }
+
+    if (m_scenario && m_options.print_summary)
+        m_scenario->print_summary();
+
+    if (!m_options.headless && m_pacer.framerate() > 0 && m_options.print_summary)
+        m_pacer.print_summary();
+
+    if (!m_options.headless && m_latency.present().count() > 0 && m_options.print_summary)
+        m_latency.print_summary();
+
+    if (!m_options.headless && !m_options.pacing_filepath.empty())
+    {
+        try
+        {
+            m_pacer.write_csv(m_options.pacing_filepath);
+        }
+        catch (const std::exception &e)
         {
-            system_enemy_spawner();
-            system_movement();
-            system_collision();
-            system_lifespan();
-            system_ability();
+            std::cerr << e.what() << std::endl;
         }
+    }
+
+    if (!m_options.headless)
+        m_window.close();
+}
+
+void Game::step() noexcept
+{
+    system_replay();
+    if (!m_running)
+        return;
+
+    RunStats *stats = stats_sink();
+    {
+        SystemTimer timer(stats, SystemId::EnemySpawner);
+        system_enemy_spawner();
+    }
+    {
+        SystemTimer timer(stats, SystemId::Movement);
+        system_movement();
+    }
+    {
+        SystemTimer timer(stats, SystemId::Collision);
+        system_collision();
+    }
+    {
+        SystemTimer timer(stats, SystemId::Lifespan);
+        system_lifespan();
+    }
+    {
+        SystemTimer timer(stats, SystemId::Ability);
+        system_ability();
+    }
+    m_tick++;
+
+    if (stats)
+        update_peak_stats();
+
+    system_state_hash();
+
+    /* Stop right after the last replayed tick */
+    if (m_replay_reader && m_replay_reader->tick() >= m_replay_reader->tick_count())
+        m_running = false;
+}
+
+void Game::seek(uint64_t tick)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    /* Restore the nearest keyframe, then simulate the remaining ticks */
+    std::string snapshot;
+    const auto keyframe = m_replay_reader->seek_keyframe(tick, snapshot);
+    if (keyframe)
+        load_snapshot(snapshot);
 
-        system_render();
+    /* Same order as the main loop, without a keyframe the spawned player is only added by the first update */
+    while (m_running && m_tick < tick)
+    {
+        m_entities.update();
+        step();
     }
 
-    m_window.close();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Seek to tick " << m_tick << " from keyframe " << keyframe.value_or(0) << " in "
+              << float_to_string(1000.0f * elapsed.count(), 1) << " ms" << std::endl;
 }
 
 void Game::init()
 {
-    // Window config
+    // World config, the simulation only depends on the view and not on the window
     const sf::Vector2u sizes{m_window_config.width, m_window_config.height};
     const sf::Vector2f sizes_f = static_cast<sf::Vector2f>(sizes);
-    m_window.create(sf::VideoMode(sizes), m_window_config.title);
-    m_window.setMinimumSize(sizes);
-    m_window.setMaximumSize(sizes);
-    m_window.setFramerateLimit(m_window_config.framerate);
-    m_window.setView(sf::View{{0.0f, 0.0f}, sizes_f});
-
-    // Score config
-    if (!m_font.openFromFile(m_score_config.font))
-        throw std::runtime_error("Could not find " + m_score_config.font);
-    
-    m_score_text.setFont(m_font);
-    m_score_text.setCharacterSize(m_score_config.size);
-    m_score_text.setFillColor(array_to_color(m_score_config.color));
-    m_score_text.setString(get_score_as_str());
-    m_score_text.setPosition(-0.5f * sizes_f + sf::Vector2f{10.0f, 10.0f});
-
-    // Pause text config
-    m_pause_text.setFont(m_font);
-    m_pause_text.setStyle(sf::Text::Bold);
-    m_pause_text.setCharacterSize(64);
-    m_pause_text.setFillColor(sf::Color::Red);
-    m_pause_text.setString("PAUSE");
-    m_pause_text.setOrigin(0.5f * m_pause_text.getLocalBounds().size);
-
-    // Ability config
-    m_cooldown_text.setFont(m_font);
-    m_cooldown_text.setCharacterSize(m_score_config.size);
-    m_cooldown_text.setFillColor(array_to_color(m_score_config.color));
-    m_cooldown_text.setString(get_ability_as_str());
-    const sf::Vector2f bounds = m_cooldown_text.getLocalBounds().size;
-    const sf::Vector2f position = {0.5f * sizes_f.x - bounds.x - 10.0f, -0.5f * sizes_f.y + 10.0f};
-    m_cooldown_text.setPosition(position);
+    m_view = sf::View{{0.0f, 0.0f}, sizes_f};
+    m_bounds = {m_view.getCenter() - 0.5f * m_view.getSize(), m_view.getSize()};
+
+    // Headless mode: no window
+    if (!m_options.headless)
+        init_window();
+
+    // Render backend
+    const RendererKind kind = m_options.renderer.value_or(m_options.headless ? RendererKind::Null : RendererKind::Sfml);
+    switch (kind)
+    {
+    case RendererKind::Null:
+        m_renderer = std::make_unique<NullRenderer>();
+        break;
+    case RendererKind::Sfml:
+        if (m_options.headless)
+            throw std::runtime_error("The sfml renderer needs a window");
+        m_renderer = std::make_unique<SfmlRenderer>(m_window, m_score_config.font);
+        break;
+    case RendererKind::Software:
+        m_render_pool = std::make_unique<ThreadPool>(m_options.render_threads);
+        m_renderer = std::make_unique<SoftwareRenderer>(sizes, *m_render_pool);
+        break;
+    }
+    m_offscreen_window = !m_options.headless && kind != RendererKind::Sfml;
+
+    /* Vertex generation workers */
+    if (m_renderer->wants_draw_list() && !m_render_pool)
+        m_render_pool = std::make_unique<ThreadPool>(m_options.render_threads);
+    m_draw_list.clear_color = array_to_color(m_window_config.color);
+
+    // Level of detail, the budget step is off for golden images since it depends on timings
+    float frame_budget = m_render_config.frame_budget;
+    if (frame_budget <= 0.0f && m_window_config.framerate > 0)
+        frame_budget = 1000.0f / static_cast<float>(m_window_config.framerate);
+    if (!m_options.frame_dump_dirpath.empty())
+        frame_budget = 0.0f;
+    m_lod = LodPolicy(m_render_config.lod_tolerance, static_cast<float>(sizes.x) / m_view.getSize().x, frame_budget);
+
+    // HUD lines: score top left, ability cooldown top right, pause centered
+    const sf::Vector2f top_left = m_view.getCenter() - 0.5f * m_view.getSize();
+    const sf::Color hud_color = array_to_color(m_score_config.color);
+    m_draw_list.texts.resize(3);
+    m_draw_list.texts[score_line] = {"", top_left + sf::Vector2f{10.0f, 10.0f}, {0.0f, 0.0f}, m_score_config.size, hud_color};
+    m_draw_list.texts[ability_line] = {"", {top_left.x + m_view.getSize().x - 10.0f, top_left.y + 10.0f}, {1.0f, 0.0f}, m_score_config.size, hud_color};
+    m_draw_list.texts[pause_line] = {"PAUSE", m_view.getCenter(), {0.5f, 0.5f}, 64, sf::Color::Red, true, false};
+    for (auto &text : m_draw_list.texts)
+        text.text.reserve(hud_capacity);
+
+    if (!m_options.frame_dump_dirpath.empty())
+        std::filesystem::create_directories(m_options.frame_dump_dirpath);
 
     // Main loop config
     spawn_player();
+
+    /* Enemy spawns need the player to be in the entity list */
+    if (m_scenario)
+    {
+        m_entities.update();
+        for (unsigned i = 0; i < m_scenario->config().initial_enemies; ++i)
+            spawn_enemy();
+    }
+}
+
+void Game::init_window()
+{
+    // Window config
+    const sf::Vector2u sizes{m_window_config.width, m_window_config.height};
+    m_window.create(sf::VideoMode(sizes), m_window_config.title);
+    m_window.setMinimumSize(sizes);
+    m_window.setMaximumSize(sizes);
+    m_pacer = FramePacer(m_scenario ? 0 : m_window_config.framerate); /* Scenarios measure unthrottled frames */
+    m_window.setView(m_view);
 }
 
 void Game::system_movement() noexcept
 {
+    PROFILE_ZONE("system_movement");
+
     /* Player */
-    static const float speed = m_player_config.speed;
+    const float speed = m_player_config.speed;
     auto player = get_player();
     assert(player->has<CInput>() && player->has<CTransform>());
     auto &input = player->get<CInput>();
@@ -134,6 +427,8 @@ void Game::system_movement() noexcept
 
 void Game::system_lifespan() noexcept
 {
+    PROFILE_ZONE("system_lifespan");
+
     for (auto entity : m_entities.get_entities())
     {
         if (!entity->has<CLifeSpan>())
@@ -146,6 +441,44 @@ void Game::system_lifespan() noexcept
     }
 }
 
+void Game::handle_event(const std::optional<sf::Event> &event) noexcept
+{
+    if (event->is<sf::Event::Closed>())
+        m_running = false;
+
+    /* Events are stamped with the previous poll, the shoot press is only tracked when the player controls the input */
+    if (event->is<sf::Event::KeyPressed>() || event->is<sf::Event::KeyReleased>() ||
+        event->is<sf::Event::MouseButtonPressed>() || event->is<sf::Event::MouseButtonReleased>())
+        m_latency.on_input(m_last_poll);
+    const auto *mouse_pressed = event->getIf<sf::Event::MouseButtonPressed>();
+    if (mouse_pressed && mouse_pressed->button == sf::Mouse::Button::Left && !m_options.bot && !m_replay_reader)
+        m_latency.on_shoot(m_last_poll);
+
+    /* A player who leaves the window pauses the game, bots and replays keep running */
+    const bool automated = m_options.bot || m_replay_reader || m_scenario;
+    if (event->is<sf::Event::FocusLost>() && !m_paused && !automated)
+    {
+        m_paused = true;
+        m_focus_paused = true;
+    }
+    if (event->is<sf::Event::FocusGained>() && m_focus_paused)
+    {
+        m_paused = false;
+        m_focus_paused = false;
+    }
+
+    /* The idle frame on screen may be stale or gone, present one again */
+    if (event->is<sf::Event::Resized>() || event->is<sf::Event::FocusGained>())
+        m_idle_frame_presented = false;
+
+    system_user_input(event);
+}
+
+[[nodiscard]] bool Game::is_idle() const noexcept
+{
+    return !m_options.headless && m_paused;
+}
+
 void Game::system_user_input(const std::optional<sf::Event> &event) noexcept
 {
     auto player = get_player();
@@ -178,32 +511,109 @@ void Game::system_user_input(const std::optional<sf::Event> &event) noexcept
     }
 }
 
+void Game::system_mouse_aim() noexcept
+{
+    /* Aim point is sampled once per tick, in world coordinates */
+    auto player = get_player();
+    assert(player->has<CInput>());
+    player->get<CInput>().aim = m_window.mapPixelToCoords(sf::Mouse::getPosition(m_window));
+    m_latency.on_aim_latched(InputLatency::Clock::now());
+}
+
+void Game::system_bot_input() noexcept
+{
+    auto player = get_player();
+    assert(player->has<CInput>() && player->has<CTransform>());
+
+    BotView view;
+    view.player_pos = player->get<CTransform>().pos;
+    view.enemies = &m_entities.get_entities("enemy");
+    view.ability_ready = !m_using_ability && m_cooldown_remaining == 0;
+    view.tick = m_tick;
+
+    m_bot.update(player->get<CInput>(), view);
+}
+
+void Game::system_replay() noexcept
+{
+    /* Replayed input overrides the live one, the run ends with the replay */
+    auto player = get_player();
+    assert(player->has<CInput>());
+    auto &input = player->get<CInput>();
+
+    if (m_replay_reader && !m_replay_reader->read(input))
+    {
+        m_running = false;
+        return;
+    }
+
+    if (m_replay_writer)
+    {
+        if (m_replay_writer->wants_keyframe())
+            m_replay_writer->write_keyframe(save_snapshot());
+        m_replay_writer->write(input);
+    }
+}
+
+void Game::system_state_hash() noexcept
+{
+    if (!m_hash_log && !m_hash_check.is_open())
+        return;
+
+    PROFILE_ZONE("system_state_hash");
+
+    const uint64_t hash = compute_state_hash();
+
+    if (m_hash_log)
+        *m_hash_log << m_tick << ' ' << std::hex << hash << std::dec << '\n';
+
+    /* Log lines are "tick hash", ticks missing from the log are skipped */
+    while (m_hash_check.is_open() && m_check_tick < m_tick)
+    {
+        if (!(m_hash_check >> m_check_tick >> std::hex >> m_check_hash >> std::dec))
+            m_hash_check.close();
+    }
+
+    if (m_hash_check.is_open() && m_check_tick == m_tick && m_check_hash != hash)
+    {
+        std::cout << "State hash mismatch at tick " << m_tick << ": expected " << std::hex << m_check_hash
+                  << ", got " << hash << std::dec << std::endl;
+        m_running = false;
+        m_failed = true;
+    }
+}
+
 void Game::system_enemy_spawner() noexcept
 {
-    static const unsigned spawn_rate = m_enemy_config.spawn_rate;
-    static unsigned frame_count = 0;
+    PROFILE_ZONE("system_enemy_spawner");
 
-    if (frame_count == spawn_rate)
+    /* Scenario ramp replaces the config spawn rate */
+    if (m_scenario && !m_scenario->config().ramp.empty())
+    {
+        for (unsigned count = m_scenario->spawn_count(m_tick); count > 0; --count)
+            spawn_enemy();
+        return;
+    }
+
+    if (m_spawn_frame_count == m_enemy_config.spawn_rate)
     {
         spawn_enemy();
-        frame_count = 0;
+        m_spawn_frame_count = 0;
     }
     else
     {
-        frame_count++;
+        m_spawn_frame_count++;
     }
 }
 
 void Game::system_collision() noexcept
 {
-    static const sf::View view = m_window.getView();
-    static const sf::Vector2f center = view.getCenter();
-    static const sf::Vector2f size = view.getSize();
+    PROFILE_ZONE("system_collision");
 
-    static const float xmin = center.x - 0.5f * size.x;
-    static const float xmax = center.x + 0.5f * size.x;
-    static const float ymin = center.y - 0.5f * size.y;
-    static const float ymax = center.y + 0.5f * size.y;
+    const float xmin = m_bounds.position.x;
+    const float xmax = m_bounds.position.x + m_bounds.size.x;
+    const float ymin = m_bounds.position.y;
+    const float ymax = m_bounds.position.y + m_bounds.size.y;
 
     /* Wall collision */
     for (const auto e : m_entities.get_entities())
@@ -304,6 +714,15 @@ void Game::system_collision() noexcept
             player->destroy();
             enemy->destroy();
 
+            /* First life statistics, before spawn_player resets the score */
+            if (m_stats.deaths++ == 0)
+            {
+                m_stats.survival_ticks = m_tick;
+                m_stats.score = m_score;
+            }
+            if (m_options.stop_on_death)
+                m_running = false;
+
             /* Spawn new player */
             spawn_player();
             break;
@@ -315,48 +734,120 @@ void Game::system_collision() noexcept
 
 void Game::system_render() noexcept
 {
-    static const sf::Color bg_color = array_to_color(m_window_config.color);
-    m_window.clear(bg_color);
+    PROFILE_ZONE("system_render");
 
-    for (const auto e : m_entities.get_entities())
+    /* The window of the other backends stays blank, it is still cleared and shown every frame */
+    if (m_offscreen_window)
     {
-        if (e->has<CShape>() && e->has<CTransform>())
-        {
-            auto &shape = e->get<CShape>().circle;
-            const auto &transform = e->get<CTransform>();
-            shape.setPosition(transform.pos);
-            shape.setRotation(shape.getRotation() + sf::degrees(transform.angle));
+        m_window.clear(m_draw_list.clear_color);
+        m_window.display();
+    }
 
-            /* Bullets */
-            if (e->has<CLifeSpan>())
+    /* Null renderer */
+    if (!m_renderer->wants_draw_list())
+        return;
+
+    /* Building and drawing the frame allocates, a renderer that cannot draw ends the run */
+    try
+    {
+        /* All shapes go into one triangle batch, in entity order */
+        m_lod.begin_frame(m_frame_cpu_ms);
+        m_shape_batch.clear();
+        for (const auto e : m_entities.get_entities())
+        {
+            if (e->has<CShape>() && e->has<CTransform>())
             {
-                auto &lifespan = e->get<CLifeSpan>();
-                auto color = shape.getFillColor();
-                color.a = 255 * static_cast<float>(lifespan.remaining) / static_cast<float>(lifespan.lifespan);
-                shape.setFillColor(color);
+                auto &shape = e->get<CShape>();
+                const auto &transform = e->get<CTransform>();
+                shape.rotation = std::fmod(shape.rotation + transform.angle, 360.0f);
+
+                /* Bullets fade out */
+                uint8_t alpha = 255;
+                if (e->has<CLifeSpan>())
+                {
+                    auto &lifespan = e->get<CLifeSpan>();
+                    alpha = static_cast<uint8_t>(255 * static_cast<float>(lifespan.remaining) / static_cast<float>(lifespan.lifespan));
+                }
+
+                m_shape_batch.add(transform.pos, shape, m_lod.points(shape), alpha);
             }
+        }
 
-            m_window.draw(shape);
+        {
+            PROFILE_ZONE("build_vertices");
+            m_shape_batch.build(m_draw_list.triangles, m_render_pool.get());
         }
+
+        update_hud();
+
+        m_frame_cpu_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_frame_start).count();
+        m_stats.vertices += m_draw_list.triangles.getVertexCount();
+        m_renderer->render(m_draw_list, m_view);
+        m_latency.on_present();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        m_running = false;
+        return;
     }
 
-    /* Draw score */
-    m_score_text.setString(get_score_as_str());
-    m_window.draw(m_score_text);
+    dump_frame();
+}
 
-    /* Draw ability cooldown */
-    m_cooldown_text.setString(get_ability_as_str());
-    m_window.draw(m_cooldown_text);
+void Game::update_hud() noexcept
+{
+    /* Formatted in fixed buffers, and only when the shown value changes */
+    if (m_score != m_hud_score || m_highscore != m_hud_highscore)
+    {
+        m_hud_score = m_score;
+        m_hud_highscore = m_highscore;
+        TextBuffer<hud_capacity> text;
+        text.append("Score: ").append(m_score).append("\nHighscore: ").append(m_highscore);
+        m_draw_list.texts[score_line].set_text(text.view());
+    }
 
-    /* Draw pause if pausing */
-    if (m_paused)
-        m_window.draw(m_pause_text);
+    const int ability = ability_hud_value();
+    if (ability != m_hud_ability)
+    {
+        m_hud_ability = ability;
+        TextBuffer<hud_capacity> text;
+        text.append("Ability\n");
+        if (ability == ability_in_use)
+            text.append("In Use");
+        else if (ability == ability_ready)
+            text.append("OK");
+        else
+            text.append("In ").append(ability / 10).append(".").append(ability % 10).append("s");
+        m_draw_list.texts[ability_line].set_text(text.view());
+    }
+
+    m_draw_list.texts[pause_line].visible = m_paused;
+}
 
-    m_window.display();
+void Game::dump_frame() noexcept
+{
+    /* Golden images: one file per dumped tick, paused frames are not dumped again */
+    if (m_options.frame_dump_dirpath.empty() || m_tick == m_last_dumped_tick || m_tick % m_options.frame_dump_interval != 0)
+        return;
+
+    m_last_dumped_tick = m_tick;
+    const std::string filepath = m_options.frame_dump_dirpath + "/tick_" + std::to_string(m_tick) + ".ppm";
+    try
+    {
+        m_renderer->save_frame(filepath);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        m_options.frame_dump_dirpath.clear();
+    }
 }
 
 void Game::system_ability() noexcept
 {
+    PROFILE_ZONE("system_ability");
+
     /*
     Berserk mode
     When right click is pressed:
@@ -365,8 +856,8 @@ void Game::system_ability() noexcept
     - Cooldown for Y frames
     */
 
-    static sf::Color ability_color = array_to_color(m_ability_config.color);
-    static sf::Color player_color = array_to_color(m_player_config.color);
+    const sf::Color ability_color = array_to_color(m_ability_config.color);
+    const sf::Color player_color = array_to_color(m_player_config.color);
 
     /* Ability is in cooldown */
     if (m_cooldown_remaining > 0 && !m_using_ability)
@@ -378,7 +869,16 @@ void Game::system_ability() noexcept
     auto player = get_player();
     assert(player->has<CShape>() && player->has<CInput>());
     auto &input = player->get<CInput>();
-    auto &shape = player->get<CShape>().circle;
+    auto &shape = player->get<CShape>();
+
+    /* Forced berserk: the ability never runs out and the player keeps shooting */
+    if (m_scenario && m_scenario->config().forced_berserk)
+    {
+        m_using_ability = true;
+        m_duration_remaining = m_ability_config.duration;
+        input.shoot = true;
+    }
+
     if (input.ability && !m_using_ability && m_cooldown_remaining == 0)
     {
         m_using_ability = true;
@@ -393,7 +893,7 @@ void Game::system_ability() noexcept
         const uint8_t red = static_cast<uint8_t>(ability_color.r * t + player_color.r * (1.0f - t));
         const uint8_t green = static_cast<uint8_t>(ability_color.g * t + player_color.g * (1.0f - t));
         const uint8_t blue = static_cast<uint8_t>(ability_color.b * t + player_color.b * (1.0f - t));
-        shape.setFillColor({red, green, blue, player_color.a});
+        shape.fill_color = {red, green, blue, player_color.a};
     }
 
     /* Check the time remaining to use the ability */
@@ -401,7 +901,7 @@ void Game::system_ability() noexcept
     {
         m_using_ability = false;
         m_duration_remaining = m_ability_config.duration;
-        shape.setFillColor(player_color);
+        shape.fill_color = player_color;
     }
 }
 
@@ -423,45 +923,39 @@ void Game::spawn_player() noexcept
 
 void Game::spawn_enemy() noexcept
 {
-    static const sf::View view = m_window.getView();
-    static const sf::Vector2f center = view.getCenter();
-    static const sf::Vector2f size = view.getSize();
-
-    static const float xmin = center.x - 0.5f * size.x;
-    static const float xmax = center.x + 0.5f * size.x;
-    static const float ymin = center.y - 0.5f * size.y;
-    static const float ymax = center.y + 0.5f * size.y;
+    const float xmin = m_bounds.position.x;
+    const float xmax = m_bounds.position.x + m_bounds.size.x;
+    const float ymin = m_bounds.position.y;
+    const float ymax = m_bounds.position.y + m_bounds.size.y;
 
     const auto player = get_player();
     assert(player->has<CTransform>() && player->has<CCollision>());
     const sf::Vector2f player_pos = player->get<CTransform>().pos;
     const float player_radius = player->get<CCollision>().radius;
 
+    /* One batch of random values per enemy: position, velocity, color, sides */
+    std::array<uint64_t, 8> values;
+    m_spawn_rng.fill(values.data(), values.size());
+
     /* Random position */
-    static std::uniform_real_distribution<float> x(xmin, xmax);
-    static std::uniform_real_distribution<float> y(ymin, ymax);
-    sf::Vector2f pos = {x(m_gen), y(m_gen)};
+    sf::Vector2f pos = {Rng::to_float(values[0], xmin, xmax), Rng::to_float(values[1], ymin, ymax)};
 
     /* Check if not overlapping player */
-    while (float dist_to_player = (pos - player_pos).lengthSquared() < 12.0f * player_radius * player_radius)
+    while ((pos - player_pos).lengthSquared() < 12.0f * player_radius * player_radius)
     {
-        pos = {x(m_gen), y(m_gen)};
+        pos = {m_spawn_rng.uniform(xmin, xmax), m_spawn_rng.uniform(ymin, ymax)};
     }
 
     /* Random velocity */
-    static std::uniform_real_distribution<float> vx(m_enemy_config.speed_min, m_enemy_config.speed_max);
-    static std::uniform_real_distribution<float> vy(m_enemy_config.speed_min, m_enemy_config.speed_max);
-    const sf::Vector2f vel = sf::Vector2f{vx(m_gen), vy(m_gen)}.normalized();
+    const float speed_min = m_enemy_config.speed_min;
+    const float speed_max = m_enemy_config.speed_max;
+    const sf::Vector2f vel = sf::Vector2f{Rng::to_float(values[2], speed_min, speed_max), Rng::to_float(values[3], speed_min, speed_max)}.normalized();
 
     /* Random color */
-    static std::uniform_int_distribution<int> r(0, 255);
-    static std::uniform_int_distribution<int> g(0, 255);
-    static std::uniform_int_distribution<int> b(0, 255);
-    const sf::Color color = {static_cast<uint8_t>(r(m_gen)), static_cast<uint8_t>(g(m_gen)), static_cast<uint8_t>(b(m_gen))};
+    const sf::Color color = {static_cast<uint8_t>(values[4] >> 56), static_cast<uint8_t>(values[5] >> 56), static_cast<uint8_t>(values[6] >> 56)};
 
     /* Random number of sides */
-    static std::uniform_int_distribution<unsigned> sides(m_enemy_config.sides_min, m_enemy_config.sides_max);
-    const unsigned n = sides(m_gen);
+    const unsigned n = Rng::to_int(values[7], m_enemy_config.sides_min, m_enemy_config.sides_max);
 
     /* Enemy creation */
     auto enemy = m_entities.add_entity("enemy");
@@ -474,24 +968,23 @@ void Game::spawn_enemy() noexcept
 void Game::spawn_small_enemies(const std::shared_ptr<Entity> enemy) noexcept
 {
     assert(enemy->has<CShape>() && enemy->has<CTransform>());
-    const auto &parent_shape = enemy->get<CShape>().circle;
+    const auto &parent_shape = enemy->get<CShape>();
     const float &parent_velocity = enemy->get<CTransform>().velocity.length();
 
     /* Children data */
-    const size_t n = parent_shape.getPointCount();
-    const sf::Vector2f position = parent_shape.getPosition();
-    static const float size = m_enemy_config.child_size;
-    static const float lifespan = m_enemy_config.child_lifespan;
+    const size_t n = parent_shape.points;
+    const sf::Vector2f position = enemy->get<CTransform>().pos;
+    const float size = m_enemy_config.child_size;
+    const int lifespan = static_cast<int>(m_enemy_config.child_lifespan);
 
     /* Create N small enemies */
     for (size_t i = 0; i < n; ++i)
     {
         /* Compute velocity */
-        const float angle = (i * 360.0 / n) * M_PI / 180.0f;
-        const sf::Vector2f velocity = sf::Vector2f{cosf(angle), sinf(angle)} * parent_velocity;
+        const sf::Vector2f velocity = polygon::direction(i, n) * parent_velocity;
 
         auto enemy = m_entities.add_entity("enemy");
-        enemy->add<CShape>(size, n, parent_shape.getFillColor());
+        enemy->add<CShape>(size, n, parent_shape.fill_color);
         enemy->add<CCollision>(size);
         enemy->add<CTransform>(position, velocity, m_enemy_config.rotation);
         enemy->add<CLifeSpan>(lifespan);
@@ -502,7 +995,11 @@ void Game::spawn_small_enemies(const std::shared_ptr<Entity> enemy) noexcept
 void Game::spawn_bullet(const sf::Vector2f &player_position) noexcept
 {
     /* Bullet data */
-    const sf::Vector2f bullet_direction = (m_window.mapPixelToCoords(sf::Mouse::getPosition(m_window)) - player_position).normalized();
+    const auto &aim = get_player()->get<CInput>().aim;
+    if (aim == player_position)
+        return;
+
+    const sf::Vector2f bullet_direction = (aim - player_position).normalized();
     const sf::Vector2f bullet_velocity = m_bullet_config.speed * bullet_direction;
 
     /* Bullet creation */
@@ -511,6 +1008,7 @@ void Game::spawn_bullet(const sf::Vector2f &player_position) noexcept
     bullet->add<CCollision>(m_bullet_config.radius);
     bullet->add<CTransform>(player_position, bullet_velocity, 0.0f);
     bullet->add<CLifeSpan>(m_bullet_config.lifespan);
+    m_latency.on_bullet_spawned();
 }
 
 void Game::handle_key_pressed(const sf::Event::KeyPressed *key_pressed, CInput &input) noexcept
@@ -533,7 +1031,10 @@ void Game::handle_key_pressed(const sf::Event::KeyPressed *key_pressed, CInput &
 
     // Pause - Unpause
     if (key_pressed->scancode == sf::Keyboard::Scancode::P)
+    {
         m_paused = !m_paused;
+        m_focus_paused = false;
+    }
 
     // Quit
     if (key_pressed->scancode == sf::Keyboard::Scancode::Escape)
@@ -582,22 +1083,76 @@ std::shared_ptr<Entity> Game::get_player() noexcept
     return players.front();
 }
 
-std::string Game::get_score_as_str() const noexcept
+[[nodiscard]] uint64_t Game::compute_state_hash() noexcept
+{
+    StateHash hash;
+    hash.add(m_tick);
+    hash.add(m_score);
+    hash.add(m_highscore);
+    hash.add(m_duration_remaining);
+    hash.add(m_cooldown_remaining);
+    hash.add(static_cast<uint64_t>(m_using_ability));
+    hash.add(static_cast<uint64_t>(m_spawn_frame_count));
+
+    for (const uint64_t word : m_spawn_rng.state())
+        hash.add(word);
+
+    /* Entities spawned this tick are still pending, they come last in the list after the next update */
+    const auto add_entity = [&hash](const std::shared_ptr<Entity> &e)
+    {
+        if (!e->is_alive())
+            return;
+
+        hash.add(static_cast<uint64_t>(e->id()));
+        if (e->has<CTransform>())
+        {
+            const auto &transform = e->get<CTransform>();
+            hash.add(transform.pos.x, transform.pos.y);
+            hash.add(transform.velocity.x, transform.velocity.y);
+        }
+        if (e->has<CLifeSpan>())
+            hash.add(e->get<CLifeSpan>().remaining);
+    };
+    for (const auto &e : m_entities.get_entities())
+        add_entity(e);
+    for (const auto &e : m_entities.get_pending_entities())
+        add_entity(e);
+
+    return hash.value();
+}
+
+[[nodiscard]] const RunStats &Game::stats() const noexcept
+{
+    return m_stats;
+}
+
+[[nodiscard]] bool Game::failed() const noexcept
+{
+    return m_failed;
+}
+
+[[nodiscard]] RunStats *Game::stats_sink() noexcept
 {
-    return "Score: " + std::to_string(m_score) + "\nHighscore: " + std::to_string(m_highscore);
+    return m_options.collect_stats ? &m_stats : nullptr;
 }
 
-std::string Game::get_ability_as_str() const noexcept
+void Game::update_peak_stats() noexcept
+{
+    /* Entities spawned during this tick are only counted after the next update */
+    m_stats.peak_entities = std::max(m_stats.peak_entities, m_entities.get_entities().size());
+    m_stats.peak_enemies = std::max(m_stats.peak_enemies, m_entities.get_entities("enemy").size());
+    m_stats.peak_bullets = std::max(m_stats.peak_bullets, m_entities.get_entities("bullet").size());
+}
+
+[[nodiscard]] int Game::ability_hud_value() const noexcept
 {
     if (m_using_ability)
-    {
-        return "Ability\nIn Use";
-    }
+        return ability_in_use;
 
     if (m_cooldown_remaining > 0)
     {
-        float t = static_cast<float>(m_cooldown_remaining) / static_cast<float>(m_window_config.framerate);
-        return "Ability\nIn " + float_to_string(t, 1) + "s";
+        const float t = static_cast<float>(m_cooldown_remaining) / static_cast<float>(m_window_config.framerate);
+        return static_cast<int>(std::lround(10.0f * t));
     }
-    return "Ability\nOK";
+    return ability_ready;
 }
@@ -1,21 +1,64 @@
 #pragma once
 
-#include <random>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <optional>
 #include <SFML/Graphics.hpp>
 
 #include "entity_manager.hpp"
+#include "replay.hpp"
 #include "config_parser.hpp"
 #include "misc.hpp"
+#include "random.hpp"
+#include "run_stats.hpp"
+#include "bot.hpp"
+#include "scenario.hpp"
+#include "renderer.hpp"
+#include "lod.hpp"
+#include "frame_pacer.hpp"
+#include "input_latency.hpp"
+#include "shape_batch.hpp"
+#include "thread_pool.hpp"
+
+struct GameOptions
+{
+    bool headless = false;  /* No window, null renderer, scripted input */
+    uint64_t max_ticks = 0; /* 0 runs until the game is closed */
+    uint64_t seed = 0;      /* Overrides the config seed, 0 keeps it */
+    bool profile = true;    /* Drives the frame counter of the process-wide profiler, only one game per process should */
+    bool print_summary = true;  /* Prints a summary line at the end of headless runs */
+    bool collect_stats = false; /* Fills RunStats, including per system timings */
+    bool stop_on_death = false; /* Ends the run when the player dies */
+    std::optional<BotPolicy> bot; /* Bot controlling the player, headless games default to scripted */
+    std::string record_filepath = "";
+    std::string replay_filepath = "";
+    uint64_t keyframe_interval = 600; /* Ticks between two world snapshots when recording, 0 disables them */
+    uint64_t seek_tick = 0;           /* Replay starts at this tick */
+    std::string hash_log_filepath = "";   /* Per tick state hashes, "-" for stdout */
+    std::string hash_check_filepath = ""; /* Stops at the first tick whose hash differs from this log */
+    std::string scenario_filepath = "";   /* Stress scenario, see scenario.hpp */
+    std::optional<RendererKind> renderer; /* Defaults to sfml with a window, null when headless */
+    size_t render_threads = 0;            /* Vertex generation and software rasterizer workers, 0 uses every hardware thread */
+    std::string frame_dump_dirpath = "";  /* Rendered frames are written there as tick_N.ppm, needs an offscreen renderer */
+    uint64_t frame_dump_interval = 1;     /* Ticks between two dumped frames */
+    std::string pacing_filepath = "";     /* Frame time and pacing error histograms, written at the end of windowed runs */
+};
 
 class Game
 {
 public:
-    Game(const std::string &config_filepath);
+    Game(const std::string &config_filepath, const GameOptions &options = {});
     void run() noexcept;
-    
+    [[nodiscard]] const RunStats &stats() const noexcept;
+    [[nodiscard]] bool failed() const noexcept; /* A --hash-check mismatch */
+
 private:
     sf::RenderWindow m_window;
+    sf::View m_view;
+    sf::FloatRect m_bounds; /* World bounds, from the view */
     EntityManager m_entities;
+    GameOptions m_options;
 
     /* Config */
     WindowConfig m_window_config;
@@ -24,37 +67,94 @@ private:
     BulletConfig m_bullet_config;
     ScoreConfig m_score_config;
     AbilityConfig m_ability_config;
+    RenderConfig m_render_config;
 
     /* Score */
-    sf::Font m_font;
-    sf::Text m_score_text;
     int m_score = 0;
     int m_highscore = 0;
 
     /* Runtime */
-    sf::Text m_pause_text;
     bool m_paused = false;
+    bool m_focus_paused = false;         /* Paused by a focus loss, resumed by the focus gain */
+    bool m_idle_frame_presented = false; /* Paused windows show one frame then wait for events */
+    bool m_offscreen_window = false;     /* A window next to a backend that does not draw in it */
     bool m_running = true;
+    bool m_failed = false;
+    uint64_t m_frame = 0;
+    uint64_t m_tick = 0; /* Simulated frames, pause excluded */
+    std::chrono::steady_clock::time_point m_frame_start;
+    std::chrono::steady_clock::time_point m_last_poll; /* Events polled later arrived after it */
+    FramePacer m_pacer; /* Windowed runs only */
+    InputLatency m_latency;
 
     /* Ability : berserk mode - unlimited shoot for X frames - player becomes red */
     int m_duration_remaining = 0;
     int m_cooldown_remaining = 0;
     bool m_using_ability = false;
-    sf::Text m_cooldown_text; /* Ability : Available - or - Ability : T s (duration remaining + cooldown remaining)*/
+
+    /* Random streams, one per system, all derived from the seed */
+    uint64_t m_seed = 0;
+    Rng m_spawn_rng;
+
+    /* Built-in player controller */
+    Bot m_bot;
 
     /* Enemy spawn */
-    static std::random_device m_rd;
-    static std::mt19937 m_gen;
+    unsigned m_spawn_frame_count = 0;
+
+    /* Input recording and replay */
+    std::unique_ptr<ReplayWriter> m_replay_writer;
+    std::unique_ptr<ReplayReader> m_replay_reader;
+
+    /* State hashing */
+    std::ofstream m_hash_log_file;
+    std::ostream *m_hash_log = nullptr;
+    std::ifstream m_hash_check;
+    uint64_t m_check_tick = 0;
+    uint64_t m_check_hash = 0;
+
+    /* Run statistics */
+    RunStats m_stats;
+
+    /* Render backend, fed with one draw list per frame */
+    std::unique_ptr<ThreadPool> m_render_pool; /* Vertex generation and software rasterization, none with the null renderer */
+    std::unique_ptr<Renderer> m_renderer;
+    DrawList m_draw_list;
+    ShapeBatch m_shape_batch;
+    int m_hud_score = -1;         /* Values shown by the HUD lines, which are only reformatted when these change */
+    int m_hud_highscore = -1;
+    int m_hud_ability = INT_MIN;  /* See ability_hud_value */
+    LodPolicy m_lod;
+    float m_frame_cpu_ms = 0.0f; /* Previous frame, from its start to the draw list submission */
+    uint64_t m_last_dumped_tick = UINT64_MAX;
+
+    /* Stress scenario */
+    std::unique_ptr<Scenario> m_scenario;
 
     void init();
+    void init_window();
+    void step() noexcept;
+    void handle_event(const std::optional<sf::Event> &event) noexcept;
+    [[nodiscard]] bool is_idle() const noexcept;
+    void seek(uint64_t tick);
+
+    /* World snapshots, see snapshot.cpp */
+    [[nodiscard]] std::string save_snapshot() noexcept;
+    void load_snapshot(const std::string &snapshot);
 
     /* Systems */
     void system_movement() noexcept;
     void system_user_input(const std::optional<sf::Event> &event) noexcept;
+    void system_mouse_aim() noexcept;
+    void system_bot_input() noexcept;
+    void system_replay() noexcept;
+    void system_state_hash() noexcept;
     void system_enemy_spawner() noexcept;
     void system_collision() noexcept;
     void system_lifespan() noexcept;
     void system_render() noexcept;
+    void update_hud() noexcept;
+    void dump_frame() noexcept;
     void system_ability() noexcept;
 
     /* Entity creation */
@@ -72,8 +172,10 @@ private:
 
     /* Helper funcs */
     std::shared_ptr<Entity> get_player() noexcept;
-    std::string get_score_as_str() const noexcept;
-    std::string get_ability_as_str() const noexcept;
+    [[nodiscard]] int ability_hud_value() const noexcept;
+    [[nodiscard]] uint64_t compute_state_hash() noexcept;
+    [[nodiscard]] RunStats *stats_sink() noexcept;
+    void update_peak_stats() noexcept;
 
     Game(const Game &) noexcept = delete;
     Game &operator=(const Game &) noexcept = delete;
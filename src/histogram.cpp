@@ -0,0 +1,84 @@
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Histogram::Histogram(double bucket_width, size_t bucket_count) : m_bucket_width(bucket_width),
+                                                                 m_buckets(bucket_count + 1, 0)
+{
+}
+
+void Histogram::add(double value) noexcept
+{
+    if (m_buckets.empty())
+        return;
+
+    value = std::max(value, 0.0);
+    const size_t bucket = std::min(static_cast<size_t>(value / m_bucket_width), m_buckets.size() - 1);
+    m_buckets[bucket]++;
+    m_min = m_count == 0 ? value : std::min(m_min, value);
+    m_max = m_count == 0 ? value : std::max(m_max, value);
+    m_sum += value;
+    m_count++;
+}
+
+void Histogram::clear() noexcept
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_count = 0;
+    m_sum = 0.0;
+    m_min = 0.0;
+    m_max = 0.0;
+}
+
+[[nodiscard]] uint64_t Histogram::count() const noexcept
+{
+    return m_count;
+}
+
+[[nodiscard]] double Histogram::min() const noexcept
+{
+    return m_min;
+}
+
+[[nodiscard]] double Histogram::max() const noexcept
+{
+    return m_max;
+}
+
+[[nodiscard]] double Histogram::mean() const noexcept
+{
+    return m_count > 0 ? m_sum / static_cast<double>(m_count) : 0.0;
+}
+
+[[nodiscard]] double Histogram::percentile(double p) const noexcept
+{
+    if (m_count == 0)
+        return 0.0;
+
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(m_count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i + 1 < m_buckets.size(); ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+            return std::min(m_max, m_bucket_width * static_cast<double>(i + 1));
+    }
+    return m_max;
+}
+
+void Histogram::write_csv(std::ostream &out, const std::string &name) const
+{
+    for (size_t i = 0; i < m_buckets.size(); ++i)
+    {
+        if (m_buckets[i] == 0)
+            continue;
+
+        out << name << ',' << m_bucket_width * static_cast<double>(i) << ',';
+        if (i + 1 < m_buckets.size())
+            out << m_bucket_width * static_cast<double>(i + 1);
+        else
+            out << "inf";
+        out << ',' << m_buckets[i] << '\n';
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Fixed width buckets starting at 0, larger values are counted in an overflow bucket */
+class Histogram
+{
+public:
+    Histogram() noexcept = default;
+    Histogram(double bucket_width, size_t bucket_count);
+
+    void add(double value) noexcept;
+    void clear() noexcept;
+
+    [[nodiscard]] uint64_t count() const noexcept;
+    [[nodiscard]] double min() const noexcept;
+    [[nodiscard]] double max() const noexcept;
+    [[nodiscard]] double mean() const noexcept;
+
+    /* Upper edge of the bucket holding the p-th percentile, max() when it is the overflow bucket */
+    [[nodiscard]] double percentile(double p) const noexcept;
+
+    /* One "name,bucket_start,bucket_end,count" line per non-empty bucket, the overflow bucket ends with inf */
+    void write_csv(std::ostream &out, const std::string &name) const;
+
+private:
+    double m_bucket_width = 1.0;
+    std::vector<uint64_t> m_buckets; /* The last one is the overflow bucket */
+    uint64_t m_count = 0;
+    double m_sum = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+};
@@ -0,0 +1,93 @@
+#include "input_latency.hpp"
+
+#include <iostream>
+
+#include "misc.hpp"
+
+namespace
+{
+    [[nodiscard]] double elapsed_ms(InputLatency::Clock::time_point since) noexcept
+    {
+        return std::chrono::duration<double, std::milli>(InputLatency::Clock::now() - since).count();
+    }
+
+    void print_percentiles(const char *name, const Histogram &histogram) noexcept
+    {
+        std::cout << name << " p50 " << float_to_string(histogram.percentile(50.0), 1) << " ms, p95 "
+                  << float_to_string(histogram.percentile(95.0), 1) << " ms, p99 " << float_to_string(histogram.percentile(99.0), 1)
+                  << " ms (" << histogram.count() << ")";
+    }
+}
+
+InputLatency::InputLatency() : m_fire(0.1, 1000),
+                               m_present(0.1, 1000),
+                               m_aim_present(0.1, 1000)
+{
+}
+
+void InputLatency::on_input(Clock::time_point time) noexcept
+{
+    if (!m_input)
+        m_input = time;
+}
+
+void InputLatency::on_shoot(Clock::time_point time) noexcept
+{
+    on_input(time);
+    m_shoot = time;
+}
+
+void InputLatency::on_aim_latched(Clock::time_point time) noexcept
+{
+    m_aim = time;
+}
+
+void InputLatency::on_bullet_spawned() noexcept
+{
+    if (!m_shoot)
+        return;
+    m_fire.add(elapsed_ms(*m_shoot));
+    m_shoot.reset();
+}
+
+void InputLatency::on_present() noexcept
+{
+    if (m_input)
+        m_present.add(elapsed_ms(*m_input));
+    if (m_aim)
+        m_aim_present.add(elapsed_ms(*m_aim));
+    m_input.reset();
+    m_aim.reset();
+}
+
+void InputLatency::drop_pending() noexcept
+{
+    m_input.reset();
+    m_shoot.reset();
+}
+
+[[nodiscard]] const Histogram &InputLatency::fire() const noexcept
+{
+    return m_fire;
+}
+
+[[nodiscard]] const Histogram &InputLatency::present() const noexcept
+{
+    return m_present;
+}
+
+[[nodiscard]] const Histogram &InputLatency::aim() const noexcept
+{
+    return m_aim_present;
+}
+
+void InputLatency::print_summary() const noexcept
+{
+    std::cout << "Input latency: ";
+    print_percentiles("fire", m_fire);
+    std::cout << " | ";
+    print_percentiles("present", m_present);
+    std::cout << " | ";
+    print_percentiles("aim", m_aim_present);
+    std::cout << std::endl;
+}
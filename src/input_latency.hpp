@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include "histogram.hpp"
+
+/*
+Input latency of windowed runs, in ms. SFML events carry no timestamp, so events are stamped with the previous poll,
+the earliest they can have arrived: the latencies are upper bounds.
+- fire: shoot button press to the spawn of its first bullet
+- present: any key or button event to the end of the first frame presented after it
+- aim: aim latch to the end of the frame drawn with it
+*/
+class InputLatency
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    InputLatency();
+
+    void on_input(Clock::time_point time) noexcept;
+    void on_shoot(Clock::time_point time) noexcept;
+    void on_aim_latched(Clock::time_point time) noexcept;
+    void on_bullet_spawned() noexcept;
+    void on_present() noexcept;
+    void drop_pending() noexcept; /* Input made while paused is not waiting for anything */
+
+    [[nodiscard]] const Histogram &fire() const noexcept;
+    [[nodiscard]] const Histogram &present() const noexcept;
+    [[nodiscard]] const Histogram &aim() const noexcept;
+
+    void print_summary() const noexcept;
+
+private:
+    std::optional<Clock::time_point> m_input;   /* Oldest input not presented yet */
+    std::optional<Clock::time_point> m_shoot;   /* Latest shoot press without a bullet yet */
+    std::optional<Clock::time_point> m_aim;     /* Latest aim latch, not presented yet */
+
+    Histogram m_fire;
+    Histogram m_present;
+    Histogram m_aim_present;
+};
@@ -0,0 +1,69 @@
+#include "lod.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "misc.hpp"
+#include "shape_batch.hpp"
+
+LodPolicy::LodPolicy(float tolerance, float pixels_per_unit, float frame_budget_ms) noexcept : m_tolerance(tolerance),
+                                                                                              m_pixels_per_unit(pixels_per_unit),
+                                                                                              m_frame_budget_ms(frame_budget_ms)
+{
+    /* An n-gon inscribed in a circle of radius r is at most r (1 - cos(pi / n)) inside of it */
+    for (size_t i = 0; i < levels.size(); ++i)
+        m_max_radius[i] = m_tolerance / (1.0f - std::cos(static_cast<float>(M_PI) / static_cast<float>(levels[i])));
+}
+
+void LodPolicy::begin_frame(float frame_ms) noexcept
+{
+    m_total_saved += m_frame_saved;
+    m_frame_saved = 0;
+    if (m_frame_budget_ms <= 0.0f)
+        return;
+
+    /* Coarsen at once, refine slowly so the level does not flicker around the budget */
+    if (frame_ms > m_frame_budget_ms)
+    {
+        m_budget_step = std::min(m_budget_step + 1, levels.size() - 1);
+        m_frames_under_budget = 0;
+    }
+    else if (frame_ms < refine_ratio * m_frame_budget_ms && m_budget_step > 0 && ++m_frames_under_budget >= refine_frames)
+    {
+        m_budget_step--;
+        m_frames_under_budget = 0;
+    }
+}
+
+[[nodiscard]] uint32_t LodPolicy::points(const CShape &shape) noexcept
+{
+    if (m_tolerance <= 0.0f || shape.points < levels.front())
+        return shape.points;
+
+    /* Coarsest level within tolerance */
+    const float radius = shape.radius * m_pixels_per_unit;
+    size_t level = 0;
+    while (level + 1 < levels.size() && radius <= m_max_radius[level + 1])
+        level++;
+    level = std::min(level + m_budget_step, levels.size() - 1);
+
+    const uint32_t points = levels[level];
+    const bool outline = shape.outline_thickness > 0.0f;
+    m_frame_saved += ShapeBatch::vertex_count(shape.points, outline) - ShapeBatch::vertex_count(points, outline);
+    return points;
+}
+
+[[nodiscard]] uint64_t LodPolicy::frame_vertices_saved() const noexcept
+{
+    return m_frame_saved;
+}
+
+[[nodiscard]] uint64_t LodPolicy::total_vertices_saved() const noexcept
+{
+    return m_total_saved + m_frame_saved;
+}
+
+[[nodiscard]] size_t LodPolicy::budget_step() const noexcept
+{
+    return m_budget_step;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "components.hpp"
+
+/*
+Level of detail for round shapes.
+Shapes with at least as many sides as the finest level are circles (bullets): they are drawn with the
+fewest sides whose gap to the true circle stays under a tolerance in pixels, so small circles lose sides.
+While the CPU frame time is over budget every circle drops one more level, and comes back once frames
+stay well under it. Shapes with fewer sides (player, enemies) are real polygons and are never changed.
+*/
+class LodPolicy
+{
+public:
+    static constexpr std::array<uint32_t, 3> levels = {36, 12, 6}; /* Finest first */
+
+    LodPolicy() noexcept = default;
+
+    /* tolerance in pixels, 0 disables the LOD; frame_budget_ms 0 disables the budget step */
+    LodPolicy(float tolerance, float pixels_per_unit, float frame_budget_ms) noexcept;
+
+    /* Adapts the budget step to the CPU time of the previous frame, and resets the frame counters */
+    void begin_frame(float frame_ms) noexcept;
+
+    /* Side count to draw the shape with, counts the vertices it saves */
+    [[nodiscard]] uint32_t points(const CShape &shape) noexcept;
+
+    [[nodiscard]] uint64_t frame_vertices_saved() const noexcept;
+    [[nodiscard]] uint64_t total_vertices_saved() const noexcept;
+    [[nodiscard]] size_t budget_step() const noexcept;
+
+private:
+    static constexpr float refine_ratio = 0.75f;  /* Frames under this part of the budget... */
+    static constexpr unsigned refine_frames = 60; /* ...for this many frames in a row refine one level */
+
+    float m_tolerance = 0.0f;
+    float m_pixels_per_unit = 1.0f;
+    float m_frame_budget_ms = 0.0f;
+    std::array<float, levels.size()> m_max_radius = {}; /* Largest on-screen radius within tolerance, per level */
+
+    size_t m_budget_step = 0;
+    unsigned m_frames_under_budget = 0;
+    uint64_t m_frame_saved = 0;
+    uint64_t m_total_saved = 0;
+};
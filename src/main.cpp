@@ -1,20 +1,57 @@
 #include <iostream>
 
+#include "cli.hpp"
 #include "config_parser.hpp"
 #include "misc.hpp"
 #include "game.hpp"
+#include "profiler.hpp"
 
-int main()
+int main(int argc, char *argv[])
 {
     try
     {
-        Game game("../resources/config.toml");
+        const CliOptions options = parse_cli(argc, argv);
+        if (options.show_help)
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+
+        if (!options.trace_filepath.empty())
+            Profiler::instance().configure(options.trace_first_frame, options.trace_frame_count);
+
+        GameOptions game_options;
+        game_options.headless = options.headless;
+        game_options.max_ticks = options.ticks;
+        game_options.bot = options.bot;
+        game_options.seed = options.seed;
+        game_options.record_filepath = options.record_filepath;
+        game_options.replay_filepath = options.replay_filepath;
+        game_options.keyframe_interval = options.keyframe_interval;
+        game_options.seek_tick = options.seek_tick;
+        game_options.hash_log_filepath = options.hash_log_filepath;
+        game_options.hash_check_filepath = options.hash_check_filepath;
+        game_options.scenario_filepath = options.scenario_filepath;
+        game_options.renderer = options.renderer;
+        game_options.render_threads = options.render_threads;
+        game_options.frame_dump_dirpath = options.frame_dump_dirpath;
+        game_options.frame_dump_interval = options.frame_dump_interval;
+        game_options.pacing_filepath = options.pacing_filepath;
+
+        Game game(options.config_filepath, game_options);
         game.run();
+
+        if (!options.trace_filepath.empty())
+            Profiler::instance().write_chrome_trace(options.trace_filepath);
+
+        if (game.failed())
+            return 1;
     }
     catch (const std::exception &e)
     {
         std::cerr << e.what() << std::endl;
+        return 1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <charconv>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <string_view>
 
 #include <SFML/Graphics.hpp>
 
@@ -28,3 +31,34 @@ inline std::string float_to_string(float value, int precision) noexcept
     out << std::fixed << std::setprecision(precision) << value;
     return out.str();
 }
+
+/* Text formatted in place with std::to_chars, never allocates, what does not fit is dropped */
+template <size_t N>
+class TextBuffer
+{
+public:
+    TextBuffer &append(std::string_view text) noexcept
+    {
+        const size_t count = std::min(text.size(), N - m_size);
+        text.copy(m_data.data() + m_size, count);
+        m_size += count;
+        return *this;
+    }
+
+    TextBuffer &append(long long value) noexcept
+    {
+        const auto result = std::to_chars(m_data.data() + m_size, m_data.data() + N, value);
+        if (result.ec == std::errc())
+            m_size = static_cast<size_t>(result.ptr - m_data.data());
+        return *this;
+    }
+
+    [[nodiscard]] std::string_view view() const noexcept
+    {
+        return {m_data.data(), m_size};
+    }
+
+private:
+    std::array<char, N> m_data;
+    size_t m_size = 0;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <SFML/Graphics.hpp>
+
+#include "deterministic_math.hpp"
+
+/*
+Unit regular polygons, built at compile time for every side count from 3 to max_sides.
+direction(i, n) is the i-th direction of an n-gon starting at angle 0, used to spawn fragments.
+vertex(i, n) is the i-th vertex with the sf::CircleShape layout, starting at the top.
+Shapes are drawn by scaling and rotating these vertices, no trigonometry runs per vertex.
+*/
+namespace polygon
+{
+    constexpr size_t max_sides = 36;
+
+    namespace detail
+    {
+        /* The n-gons are stored one after the other, starting with the triangle */
+        constexpr size_t offset(size_t n) noexcept
+        {
+            return n * (n - 1) / 2 - 3;
+        }
+
+        constexpr size_t entry_count = offset(max_sides + 1);
+
+        constexpr double wrap(double angle) noexcept
+        {
+            while (angle > dmath::detail::pi)
+                angle -= 2.0 * dmath::detail::pi;
+            return angle;
+        }
+
+        /* Side counts dividing the sine table size read it, so deterministic results are unchanged */
+        constexpr sf::Vector2f unit_direction(size_t i, size_t n) noexcept
+        {
+            if (dmath::table_size % n == 0)
+            {
+                const size_t index = (i * (dmath::table_size / n)) % dmath::table_size;
+                return {dmath::detail::sin_table[(index + dmath::table_size / 4) % dmath::table_size], dmath::detail::sin_table[index]};
+            }
+            const double angle = 2.0 * dmath::detail::pi * static_cast<double>(i) / static_cast<double>(n);
+            return {static_cast<float>(dmath::detail::sin_series(wrap(angle + 0.5 * dmath::detail::pi))),
+                    static_cast<float>(dmath::detail::sin_series(wrap(angle)))};
+        }
+
+        constexpr std::array<sf::Vector2f, entry_count> make_directions() noexcept
+        {
+            std::array<sf::Vector2f, entry_count> table{};
+            for (size_t n = 3; n <= max_sides; ++n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    table[offset(n) + i] = unit_direction(i, n);
+            }
+            return table;
+        }
+
+        inline constexpr std::array<sf::Vector2f, entry_count> directions = make_directions();
+    }
+
+    inline sf::Vector2f direction(size_t i, size_t n) noexcept
+    {
+        if (n >= 3 && n <= max_sides)
+            return detail::directions[detail::offset(n) + i % n];
+
+        const float angle = 2.0f * static_cast<float>(dmath::detail::pi) * static_cast<float>(i) / static_cast<float>(n);
+        return {dmath::cos(angle), dmath::sin(angle)};
+    }
+
+    /* A quarter turn behind direction(i, n): cos(a - pi/2) = sin(a), sin(a - pi/2) = -cos(a) */
+    inline sf::Vector2f vertex(size_t i, size_t n) noexcept
+    {
+        const sf::Vector2f d = direction(i, n);
+        return {d.y, -d.x};
+    }
+
+    /* Cosine and sine of a rendering angle, interpolated from the sine table */
+    inline sf::Vector2f rotation(sf::Angle angle) noexcept
+    {
+        const float turns = angle.asDegrees() / 360.0f;
+        return {dmath::detail::lookup(turns + 0.25f), dmath::detail::lookup(turns)};
+    }
+}
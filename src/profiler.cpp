@@ -0,0 +1,134 @@
+#include "profiler.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+[[nodiscard]] Profiler &Profiler::instance() noexcept
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+[[nodiscard]] int64_t Profiler::now() noexcept
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::steady_clock::now() - epoch;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void Profiler::configure(uint64_t first_frame, uint64_t frame_count) noexcept
+{
+    m_first_frame = first_frame;
+    m_last_frame = first_frame + frame_count;
+    m_enabled.store(frame_count > 0, std::memory_order_relaxed);
+    begin_frame(m_frame.load(std::memory_order_relaxed));
+}
+
+void Profiler::begin_frame(uint64_t frame) noexcept
+{
+    m_frame.store(frame, std::memory_order_relaxed);
+    const bool recording = m_enabled.load(std::memory_order_relaxed) && frame >= m_first_frame && frame < m_last_frame;
+    m_recording.store(recording, std::memory_order_relaxed);
+}
+
+void Profiler::record(const char *name, int64_t start, int64_t end) noexcept
+{
+    ThreadBuffer *buffer = nullptr;
+    try
+    {
+        buffer = &local_buffer();
+    }
+    catch (const std::exception &)
+    {
+        return;
+    }
+
+    /* Single writer: only the owner thread touches its own size */
+    const size_t size = buffer->size.load(std::memory_order_relaxed);
+    if (size == buffer->events.size())
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[size] = {name, start, end, m_frame.load(std::memory_order_relaxed)};
+    buffer->size.store(size + 1, std::memory_order_release);
+}
+
+[[nodiscard]] bool Profiler::is_recording() const noexcept
+{
+    return m_recording.load(std::memory_order_relaxed);
+}
+
+[[nodiscard]] uint64_t Profiler::frame() const noexcept
+{
+    return m_frame.load(std::memory_order_relaxed);
+}
+
+void Profiler::write_chrome_trace(const std::string &filepath) const
+{
+    std::ofstream file(filepath);
+    if (!file)
+        throw std::runtime_error("Could not open " + filepath);
+
+    std::lock_guard lock(m_registry_mutex);
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Geometry Wars SFML\"}}";
+
+    for (const auto &buffer : m_buffers)
+    {
+        const size_t size = buffer->size.load(std::memory_order_acquire);
+        const std::string thread_name = buffer->tid == 0 ? "main" : "worker " + std::to_string(buffer->tid);
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+             << ",\"args\":{\"name\":\"" << thread_name << "\"}}";
+
+        /* trace_event timestamps are in microseconds */
+        for (size_t i = 0; i < size; ++i)
+        {
+            const auto &event = buffer->events[i];
+            file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"ts\":" << static_cast<double>(event.start) / 1000.0
+                 << ",\"dur\":" << static_cast<double>(event.end - event.start) / 1000.0
+                 << ",\"args\":{\"frame\":" << event.frame << "}}";
+        }
+
+        const size_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            file << ",\n{\"name\":\"dropped zones\",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"ts\":0,\"args\":{\"dropped\":" << dropped << "}}";
+        }
+    }
+
+    file << "\n]}\n";
+}
+
+[[nodiscard]] Profiler::ThreadBuffer &Profiler::local_buffer()
+{
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer)
+        return *buffer;
+
+    std::lock_guard lock(m_registry_mutex);
+    auto new_buffer = std::make_unique<ThreadBuffer>();
+    new_buffer->tid = static_cast<uint32_t>(m_buffers.size());
+    new_buffer->events.resize(thread_capacity);
+    buffer = new_buffer.get();
+    m_buffers.push_back(std::move(new_buffer));
+    return *buffer;
+}
+
+ProfileZone::ProfileZone(const char *name) noexcept : m_name(name)
+{
+    if (Profiler::instance().is_recording())
+        m_start = Profiler::now();
+}
+
+ProfileZone::~ProfileZone() noexcept
+{
+    if (m_start >= 0)
+        Profiler::instance().record(m_name, m_start, Profiler::now());
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* One timed zone, timestamps in nanoseconds since the profiler epoch */
+struct ProfileEvent
+{
+    const char *name = nullptr;
+    int64_t start = 0;
+    int64_t end = 0;
+    uint64_t frame = 0;
+};
+
+/*
+Records profile zones of every thread into per-thread buffers.
+Each buffer is only written by its owner thread and published with an atomic size,
+so recording a zone never takes a lock. Zones are only kept for the frame window
+given to configure(), and can be dumped as a Chrome / Perfetto trace_event JSON file.
+*/
+class Profiler
+{
+public:
+    static constexpr size_t thread_capacity = 1 << 18;
+
+    [[nodiscard]] static Profiler &instance() noexcept;
+    [[nodiscard]] static int64_t now() noexcept;
+
+    void configure(uint64_t first_frame, uint64_t frame_count) noexcept;
+    void begin_frame(uint64_t frame) noexcept;
+    void record(const char *name, int64_t start, int64_t end) noexcept;
+
+    [[nodiscard]] bool is_recording() const noexcept;
+    [[nodiscard]] uint64_t frame() const noexcept;
+
+    void write_chrome_trace(const std::string &filepath) const;
+
+private:
+    struct ThreadBuffer
+    {
+        uint32_t tid = 0;
+        std::vector<ProfileEvent> events;
+        std::atomic<size_t> size = 0;
+        std::atomic<size_t> dropped = 0;
+    };
+
+    std::atomic<bool> m_enabled = false;
+    std::atomic<bool> m_recording = false;
+    std::atomic<uint64_t> m_frame = 0;
+    uint64_t m_first_frame = 0;
+    uint64_t m_last_frame = 0;
+
+    /* Only locked when a thread records its first zone or when dumping */
+    mutable std::mutex m_registry_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+    Profiler() noexcept = default;
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    [[nodiscard]] ThreadBuffer &local_buffer();
+};
+
+/* RAII zone, records its lifetime if the profiler is recording */
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char *name) noexcept;
+    ~ProfileZone() noexcept;
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    const char *m_name;
+    int64_t m_start = -1;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+xoshiro256** generator, 32 bytes of state.
+Streams built from the same seed with different ids are independent, so each system
+draws from its own stream and adding draws to one system never shifts the others.
+Mapping to floats and integers is done here instead of std distributions, whose
+results are implementation defined.
+*/
+class Rng
+{
+public:
+    using State = std::array<uint64_t, 4>;
+
+    Rng() noexcept : Rng(0, 0)
+    {
+    }
+
+    Rng(uint64_t seed, uint64_t stream) noexcept
+    {
+        uint64_t x = seed ^ (stream * 0xd1342543de82ef95ULL);
+        for (auto &s : m_state)
+            s = splitmix64(x);
+    }
+
+    [[nodiscard]] uint64_t next() noexcept
+    {
+        const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    /* Batch generation of raw values */
+    void fill(uint64_t *values, size_t count) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+            values[i] = next();
+    }
+
+    [[nodiscard]] float uniform(float min, float max) noexcept
+    {
+        return to_float(next(), min, max);
+    }
+
+    [[nodiscard]] unsigned uniform_int(unsigned min, unsigned max) noexcept
+    {
+        return to_int(next(), min, max);
+    }
+
+    /* Uniform in [min, max), from the top 24 bits so every value is exact */
+    [[nodiscard]] static float to_float(uint64_t value, float min, float max) noexcept
+    {
+        const float unit = static_cast<float>(value >> 40) * 0x1.0p-24f;
+        return min + (max - min) * unit;
+    }
+
+    /* Uniform in [min, max] by multiply-shift, bias is negligible for small ranges */
+    [[nodiscard]] static unsigned to_int(uint64_t value, unsigned min, unsigned max) noexcept
+    {
+        const uint64_t range = static_cast<uint64_t>(max) - min + 1;
+        return min + static_cast<unsigned>(((value >> 32) * range) >> 32);
+    }
+
+    [[nodiscard]] const State &state() const noexcept
+    {
+        return m_state;
+    }
+
+    void set_state(const State &state) noexcept
+    {
+        m_state = state;
+    }
+
+private:
+    State m_state = {};
+
+    [[nodiscard]] static uint64_t rotl(uint64_t x, int k) noexcept
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    [[nodiscard]] static uint64_t splitmix64(uint64_t &x) noexcept
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+/* Render backends, selected at runtime */
+enum class RendererKind
+{
+    Null,    /* Draws nothing, the simulation cost alone */
+    Sfml,    /* The game window */
+    Software /* CPU rasterizer into an offscreen framebuffer, no OpenGL context */
+};
+
+constexpr std::array<const char *, 3> renderer_kind_names = {"null", "sfml", "software"};
+
+[[nodiscard]] inline const char *to_string(RendererKind kind) noexcept
+{
+    return renderer_kind_names[static_cast<size_t>(kind)];
+}
+
+[[nodiscard]] inline RendererKind renderer_kind_from_string(const std::string &name)
+{
+    for (size_t i = 0; i < renderer_kind_names.size(); ++i)
+    {
+        if (name == renderer_kind_names[i])
+            return static_cast<RendererKind>(i);
+    }
+    throw std::runtime_error("Unknown renderer " + name);
+}
+
+/*
+HUD line, anchor is the point of its bounds placed at position: {0, 0} top left, {1, 0} top right, {0.5, 0.5} center.
+Lines live across frames: the owner bumps revision whenever text or style changes, so backends can keep their layout.
+*/
+struct HudText
+{
+    std::string text;
+    sf::Vector2f position = {0.0f, 0.0f};
+    sf::Vector2f anchor = {0.0f, 0.0f};
+    unsigned character_size = 30;
+    sf::Color color = sf::Color::White;
+    bool bold = false;
+    bool visible = true;
+    uint64_t revision = 0;
+
+    /* Replaces the text, reusing the string capacity */
+    void set_text(std::string_view value) noexcept
+    {
+        if (value == text)
+            return;
+        text.assign(value.data(), value.size());
+        revision++;
+    }
+};
+
+/* Everything drawn in one frame, in world coordinates */
+struct DrawList
+{
+    sf::Color clear_color = sf::Color::Black;
+    sf::VertexArray triangles{sf::PrimitiveType::Triangles};
+    std::vector<HudText> texts; /* Drawn over the triangles, persistent */
+};
+
+class Renderer
+{
+public:
+    virtual ~Renderer() = default;
+
+    /* Backends that draw nothing skip the draw list construction */
+    [[nodiscard]] virtual bool wants_draw_list() const noexcept
+    {
+        return true;
+    }
+
+    virtual void render(const DrawList &list, const sf::View &view) = 0;
+
+    /* Offscreen backends write their last frame */
+    virtual void save_frame(const std::string &filepath) const
+    {
+        throw std::runtime_error(std::string("The ") + name() + " renderer cannot save frames to " + filepath);
+    }
+
+    [[nodiscard]] virtual const char *name() const noexcept = 0;
+};
+
+class NullRenderer : public Renderer
+{
+public:
+    [[nodiscard]] bool wants_draw_list() const noexcept override
+    {
+        return false;
+    }
+
+    void render(const DrawList &, const sf::View &) override
+    {
+    }
+
+    [[nodiscard]] const char *name() const noexcept override
+    {
+        return to_string(RendererKind::Null);
+    }
+};
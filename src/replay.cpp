@@ -0,0 +1,296 @@
+#include "replay.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "serialization.hpp"
+
+namespace
+{
+    /* magic + version + seed */
+    constexpr std::streamoff tick_count_offset = sizeof(replay::magic) + sizeof(replay::version) + sizeof(uint64_t);
+    constexpr std::streamoff footer_size = sizeof(uint64_t) + sizeof(replay::index_magic);
+}
+
+ReplayWriter::ReplayWriter(const std::string &filepath, uint64_t seed, uint64_t keyframe_interval) : m_file(filepath, std::ios::binary),
+                                                                                                     m_keyframe_interval(keyframe_interval)
+{
+    if (!m_file)
+        throw std::runtime_error("Could not open " + filepath);
+    write_header(seed);
+}
+
+ReplayWriter::~ReplayWriter() noexcept
+{
+    write_index();
+
+    /* Patch the tick count in the header */
+    m_file.seekp(tick_count_offset);
+    serial::write_le(m_file, m_tick_count);
+}
+
+void ReplayWriter::write(const CInput &input) noexcept
+{
+    uint8_t flags = 0;
+    flags |= input.up ? replay::Up : 0;
+    flags |= input.down ? replay::Down : 0;
+    flags |= input.left ? replay::Left : 0;
+    flags |= input.right ? replay::Right : 0;
+    flags |= input.shoot ? replay::Shoot : 0;
+    flags |= input.ability ? replay::Ability : 0;
+
+    /* The first record after a keyframe always carries the aim, so seeking never depends on older records */
+    const bool aim_changed = m_force_aim || input.aim != m_last_aim;
+    flags |= aim_changed ? replay::AimChanged : 0;
+
+    m_file.put(static_cast<char>(flags));
+    if (aim_changed)
+    {
+        serial::write_float(m_file, input.aim.x);
+        serial::write_float(m_file, input.aim.y);
+        m_last_aim = input.aim;
+        m_force_aim = false;
+    }
+
+    m_tick_count++;
+}
+
+void ReplayWriter::write_keyframe(const std::string &snapshot) noexcept
+{
+    m_index.push_back({m_tick_count, static_cast<uint64_t>(m_file.tellp())});
+
+    m_file.put(static_cast<char>(replay::Keyframe));
+    serial::write_le(m_file, m_tick_count);
+    serial::write_string(m_file, snapshot);
+    m_force_aim = true;
+}
+
+[[nodiscard]] bool ReplayWriter::wants_keyframe() const noexcept
+{
+    return m_keyframe_interval > 0 && m_tick_count % m_keyframe_interval == 0;
+}
+
+[[nodiscard]] uint64_t ReplayWriter::tick_count() const noexcept
+{
+    return m_tick_count;
+}
+
+void ReplayWriter::write_header(uint64_t seed) noexcept
+{
+    m_file.write(replay::magic, sizeof(replay::magic));
+    serial::write_le(m_file, replay::version);
+    serial::write_le(m_file, seed);
+    serial::write_le(m_file, m_tick_count);
+}
+
+void ReplayWriter::write_index() noexcept
+{
+    const auto index_offset = static_cast<uint64_t>(m_file.tellp());
+    serial::write_le(m_file, static_cast<uint64_t>(m_index.size()));
+    for (const auto &entry : m_index)
+    {
+        serial::write_le(m_file, entry.tick);
+        serial::write_le(m_file, entry.offset);
+    }
+
+    serial::write_le(m_file, index_offset);
+    m_file.write(replay::index_magic, sizeof(replay::index_magic));
+}
+
+ReplayReader::ReplayReader(const std::string &filepath) : m_file(filepath, std::ios::binary)
+{
+    if (!m_file)
+        throw std::runtime_error("Could not open " + filepath);
+
+    char magic[sizeof(replay::magic)] = {};
+    uint32_t version = 0;
+    m_file.read(magic, sizeof(magic));
+    if (!m_file || std::memcmp(magic, replay::magic, sizeof(magic)) != 0)
+        throw std::runtime_error(filepath + " is not a replay file");
+    if (!serial::read_le(m_file, version) || version != replay::version)
+        throw std::runtime_error(filepath + ": unsupported replay version " + std::to_string(version));
+    if (!serial::read_le(m_file, m_seed) || !serial::read_le(m_file, m_tick_count))
+        throw std::runtime_error(filepath + ": truncated replay header");
+
+    read_index();
+}
+
+[[nodiscard]] bool ReplayReader::read(CInput &input) noexcept
+{
+    if (m_tick >= m_tick_count)
+        return false;
+
+    int flags = m_file.get();
+    while (flags != std::char_traits<char>::eof() && (flags & replay::Keyframe))
+    {
+        if (!skip_keyframe())
+            return false;
+        flags = m_file.get();
+    }
+
+    if (flags == std::char_traits<char>::eof())
+        return false;
+
+    if (flags & replay::AimChanged)
+    {
+        if (!serial::read_float(m_file, m_last_aim.x) || !serial::read_float(m_file, m_last_aim.y))
+            return false;
+    }
+
+    input.up = flags & replay::Up;
+    input.down = flags & replay::Down;
+    input.left = flags & replay::Left;
+    input.right = flags & replay::Right;
+    input.shoot = flags & replay::Shoot;
+    input.ability = flags & replay::Ability;
+    input.aim = m_last_aim;
+
+    m_tick++;
+    return true;
+}
+
+[[nodiscard]] std::optional<uint64_t> ReplayReader::seek_keyframe(uint64_t tick, std::string &snapshot) noexcept
+{
+    /* Nearest keyframe at or before the tick */
+    const auto it = std::upper_bound(m_index.begin(), m_index.end(), tick,
+                                     [](uint64_t t, const replay::IndexEntry &entry)
+                                     { return t < entry.tick; });
+    if (it == m_index.begin())
+        return std::nullopt;
+
+    /* A bad keyframe leaves the reader where it was */
+    const std::streampos position = m_file.tellg();
+    const std::ios_base::iostate state = m_file.rdstate();
+
+    const auto &entry = *std::prev(it);
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(entry.offset));
+
+    uint64_t keyframe_tick = 0;
+    std::string keyframe_snapshot;
+    const int marker = m_file.get();
+    if (marker == std::char_traits<char>::eof() || !(marker & replay::Keyframe) ||
+        !serial::read_le(m_file, keyframe_tick) || keyframe_tick != entry.tick ||
+        !serial::read_string(m_file, keyframe_snapshot))
+    {
+        m_file.clear();
+        m_file.seekg(position);
+        m_file.setstate(state);
+        return std::nullopt;
+    }
+
+    snapshot = std::move(keyframe_snapshot);
+    m_tick = keyframe_tick;
+    return keyframe_tick;
+}
+
+[[nodiscard]] uint64_t ReplayReader::seed() const noexcept
+{
+    return m_seed;
+}
+
+[[nodiscard]] uint64_t ReplayReader::tick_count() const noexcept
+{
+    return m_tick_count;
+}
+
+[[nodiscard]] uint64_t ReplayReader::tick() const noexcept
+{
+    return m_tick;
+}
+
+[[nodiscard]] const std::vector<replay::IndexEntry> &ReplayReader::index() const noexcept
+{
+    return m_index;
+}
+
+void ReplayReader::read_index() noexcept
+{
+    /* Files without a valid footer (e.g. interrupted recordings) are scanned instead, see scan_records */
+    const std::streampos records_start = m_file.tellg();
+    m_file.seekg(0, std::ios::end);
+    const std::streamoff file_size = m_file.tellg();
+
+    uint64_t index_offset = 0;
+    uint64_t count = 0;
+    char magic[sizeof(replay::index_magic)] = {};
+    bool has_footer = false;
+    if (file_size >= footer_size + records_start)
+    {
+        m_file.seekg(file_size - footer_size);
+        if (serial::read_le(m_file, index_offset) && m_file.read(magic, sizeof(magic)) &&
+            std::memcmp(magic, replay::index_magic, sizeof(magic)) == 0)
+        {
+            has_footer = true;
+            m_file.seekg(static_cast<std::streamoff>(index_offset));
+            if (serial::read_le(m_file, count))
+            {
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    replay::IndexEntry entry;
+                    if (!serial::read_le(m_file, entry.tick) || !serial::read_le(m_file, entry.offset))
+                    {
+                        m_index.clear();
+                        break;
+                    }
+                    m_index.push_back(entry);
+                }
+            }
+        }
+    }
+
+    m_file.clear();
+    m_file.seekg(records_start);
+    if (!has_footer)
+        scan_records();
+}
+
+void ReplayReader::scan_records() noexcept
+{
+    /* The header tick count is only patched when the recording ends: count the complete records and index the keyframes */
+    const std::streampos records_start = m_file.tellg();
+    m_file.seekg(0, std::ios::end);
+    const std::streampos file_end = m_file.tellg();
+    m_file.seekg(records_start);
+    m_index.clear();
+    m_tick_count = 0;
+
+    while (true)
+    {
+        const std::streampos offset = m_file.tellg();
+        const int flags = m_file.get();
+        if (flags == std::char_traits<char>::eof())
+            break;
+
+        if (flags & replay::Keyframe)
+        {
+            uint64_t tick = 0;
+            uint32_t size = 0;
+            if (!serial::read_le(m_file, tick) || tick != m_tick_count || !serial::read_le(m_file, size) ||
+                file_end - m_file.tellg() < static_cast<std::streamoff>(size))
+                break;
+            m_file.seekg(size, std::ios::cur);
+            m_index.push_back({tick, static_cast<uint64_t>(offset)});
+            continue;
+        }
+
+        float aim = 0.0f;
+        if ((flags & replay::AimChanged) && (!serial::read_float(m_file, aim) || !serial::read_float(m_file, aim)))
+            break;
+        m_tick_count++;
+    }
+
+    m_file.clear();
+    m_file.seekg(records_start);
+}
+
+[[nodiscard]] bool ReplayReader::skip_keyframe() noexcept
+{
+    uint64_t tick = 0;
+    uint32_t size = 0;
+    if (!serial::read_le(m_file, tick) || !serial::read_le(m_file, size))
+        return false;
+    m_file.seekg(size, std::ios::cur);
+    return static_cast<bool>(m_file);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "components.hpp"
+
+/*
+Binary replay file, little-endian:
+- Header: magic "GWRP", version (u32), seed (u64), tick count (u64)
+- One record per simulated tick:
+    - flags (u8): up, down, left, right, shoot, ability, aim changed
+    - aim x, aim y (2 x f32), only if the aim changed since the previous tick
+- Keyframe records, written before the input of their tick:
+    - marker (u8), tick (u64), world snapshot (u32 size + bytes)
+- Index: keyframe count (u64), then (tick, file offset) pairs (2 x u64)
+- Footer: index offset (u64), magic "GWIX"
+*/
+namespace replay
+{
+    constexpr char magic[4] = {'G', 'W', 'R', 'P'};
+    constexpr char index_magic[4] = {'G', 'W', 'I', 'X'};
+    constexpr uint32_t version = 3;
+
+    enum Flags : uint8_t
+    {
+        Up = 1 << 0,
+        Down = 1 << 1,
+        Left = 1 << 2,
+        Right = 1 << 3,
+        Shoot = 1 << 4,
+        Ability = 1 << 5,
+        AimChanged = 1 << 6,
+        Keyframe = 1 << 7
+    };
+
+    struct IndexEntry
+    {
+        uint64_t tick = 0;
+        uint64_t offset = 0;
+    };
+}
+
+class ReplayWriter
+{
+public:
+    ReplayWriter(const std::string &filepath, uint64_t seed, uint64_t keyframe_interval);
+    ~ReplayWriter() noexcept;
+
+    void write(const CInput &input) noexcept;
+    void write_keyframe(const std::string &snapshot) noexcept;
+
+    [[nodiscard]] bool wants_keyframe() const noexcept;
+    [[nodiscard]] uint64_t tick_count() const noexcept;
+
+private:
+    std::ofstream m_file;
+    uint64_t m_tick_count = 0;
+    uint64_t m_keyframe_interval = 0;
+    sf::Vector2f m_last_aim = {0.0f, 0.0f};
+    bool m_force_aim = true;
+    std::vector<replay::IndexEntry> m_index;
+
+    void write_header(uint64_t seed) noexcept;
+    void write_index() noexcept;
+
+    ReplayWriter(const ReplayWriter &) = delete;
+    ReplayWriter &operator=(const ReplayWriter &) = delete;
+};
+
+class ReplayReader
+{
+public:
+    ReplayReader(const std::string &filepath);
+
+    [[nodiscard]] bool read(CInput &input) noexcept;
+    [[nodiscard]] std::optional<uint64_t> seek_keyframe(uint64_t tick, std::string &snapshot) noexcept;
+
+    [[nodiscard]] uint64_t seed() const noexcept;
+    [[nodiscard]] uint64_t tick_count() const noexcept;
+    [[nodiscard]] uint64_t tick() const noexcept;
+    [[nodiscard]] const std::vector<replay::IndexEntry> &index() const noexcept;
+
+private:
+    std::ifstream m_file;
+    uint64_t m_seed = 0;
+    uint64_t m_tick_count = 0;
+    uint64_t m_tick = 0;
+    sf::Vector2f m_last_aim = {0.0f, 0.0f};
+    std::vector<replay::IndexEntry> m_index;
+
+    void read_index() noexcept;
+    void scan_records() noexcept;
+    [[nodiscard]] bool skip_keyframe() noexcept;
+
+    ReplayReader(const ReplayReader &) = delete;
+    ReplayReader &operator=(const ReplayReader &) = delete;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/* Systems timed by Game when GameOptions::collect_stats is set */
+enum class SystemId : size_t
+{
+    EntityUpdate,
+    EnemySpawner,
+    Movement,
+    Collision,
+    Lifespan,
+    Ability,
+    Render,
+    Count
+};
+
+constexpr std::array<const char *, static_cast<size_t>(SystemId::Count)> system_names = {
+    "entity_update", "enemy_spawner", "movement", "collision", "lifespan", "ability", "render"};
+
+struct RunStats
+{
+    uint64_t ticks = 0;
+    uint64_t survival_ticks = 0; /* Ticks before the first death, all ticks if the player survived */
+    uint64_t deaths = 0;
+    int score = 0; /* Score of the first life */
+    int highscore = 0;
+
+    size_t peak_entities = 0;
+    size_t peak_enemies = 0;
+    size_t peak_bullets = 0;
+
+    uint64_t vertices = 0;       /* Drawn, over the whole run */
+    uint64_t vertices_saved = 0; /* Left out by the level of detail */
+
+    std::array<int64_t, static_cast<size_t>(SystemId::Count)> system_ns = {};
+    std::array<uint64_t, static_cast<size_t>(SystemId::Count)> system_calls = {};
+
+    [[nodiscard]] double average_us(SystemId id) const noexcept
+    {
+        const size_t i = static_cast<size_t>(id);
+        return system_calls[i] > 0 ? static_cast<double>(system_ns[i]) / (1000.0 * static_cast<double>(system_calls[i])) : 0.0;
+    }
+};
+
+/* Adds its lifetime to a RunStats system entry */
+class SystemTimer
+{
+public:
+    SystemTimer(RunStats *stats, SystemId id) noexcept : m_stats(stats), m_id(static_cast<size_t>(id))
+    {
+        if (m_stats)
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~SystemTimer() noexcept
+    {
+        if (!m_stats)
+            return;
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_stats->system_ns[m_id] += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        m_stats->system_calls[m_id]++;
+    }
+
+    SystemTimer(const SystemTimer &) = delete;
+    SystemTimer &operator=(const SystemTimer &) = delete;
+
+private:
+    RunStats *m_stats;
+    size_t m_id;
+    std::chrono::steady_clock::time_point m_start;
+};
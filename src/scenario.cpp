@@ -0,0 +1,186 @@
+#include "scenario.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <toml.hpp>
+
+#include "misc.hpp"
+
+namespace
+{
+    /* TOML integers are not implicitly converted to floats */
+    [[nodiscard]] float to_float(const toml::value &value)
+    {
+        return value.is_integer() ? static_cast<float>(value.as_integer()) : static_cast<float>(value.as_floating());
+    }
+
+    [[nodiscard]] double to_ms(int64_t ns, uint64_t frames) noexcept
+    {
+        return frames > 0 ? static_cast<double>(ns) / (1.0e6 * static_cast<double>(frames)) : 0.0;
+    }
+}
+
+/*
+Scenario file:
+[scenario]
+name = "stress"
+initial_enemies = 1000
+forced_berserk = true
+bot = "berserk"
+targets = [10000, 100000, 1000000]
+max_ticks = 0
+report_interval = 60
+report = "scenario_report.csv"
+
+[[scenario.ramp]]
+tick = 0
+rate = 1.0 # enemies per tick
+*/
+[[nodiscard]] ScenarioConfig load_scenario(const std::string &filepath)
+{
+    const auto data = toml::parse(filepath);
+    if (!data.contains("scenario"))
+        throw std::runtime_error(filepath + " has no [scenario] table");
+    const auto &table = toml::find(data, "scenario");
+
+    ScenarioConfig config;
+    config.name = toml::find_or<std::string>(table, "name", filepath);
+    config.initial_enemies = toml::find_or<unsigned>(table, "initial_enemies", 0u);
+    config.forced_berserk = toml::find_or<bool>(table, "forced_berserk", false);
+    if (table.contains("bot"))
+        config.bot = bot_policy_from_string(toml::find<std::string>(table, "bot"));
+    config.targets = toml::find_or<std::vector<uint64_t>>(table, "targets", {});
+    config.max_ticks = toml::find_or<uint64_t>(table, "max_ticks", 0);
+    config.report_interval = std::max<uint64_t>(1, toml::find_or<uint64_t>(table, "report_interval", 60));
+    config.report_filepath = toml::find_or<std::string>(table, "report", "");
+
+    if (table.contains("ramp"))
+    {
+        for (const auto &point : toml::find(table, "ramp").as_array())
+            config.ramp.push_back({toml::find<uint64_t>(point, "tick"), to_float(toml::find(point, "rate"))});
+    }
+
+    std::sort(config.ramp.begin(), config.ramp.end(), [](const auto &a, const auto &b)
+              { return a.tick < b.tick; });
+    std::sort(config.targets.begin(), config.targets.end());
+
+    return config;
+}
+
+Scenario::Scenario(const ScenarioConfig &config, bool print_targets) : m_config(config), m_print_targets(print_targets)
+{
+    if (m_config.report_filepath.empty())
+        return;
+
+    m_report.open(m_config.report_filepath);
+    if (!m_report)
+        throw std::runtime_error("Could not open " + m_config.report_filepath);
+
+    m_report << "tick,entities,enemies,bullets,frames,frame_avg_ms,frame_max_ms";
+    for (const char *name : system_names)
+        m_report << ",avg_ms_" << name;
+    m_report << ",target\n";
+}
+
+[[nodiscard]] const ScenarioConfig &Scenario::config() const noexcept
+{
+    return m_config;
+}
+
+[[nodiscard]] float Scenario::spawn_rate(uint64_t tick) const noexcept
+{
+    const auto &ramp = m_config.ramp;
+    if (ramp.empty())
+        return 0.0f;
+    if (tick <= ramp.front().tick)
+        return ramp.front().rate;
+
+    for (size_t i = 1; i < ramp.size(); ++i)
+    {
+        if (tick < ramp[i].tick)
+        {
+            const auto &a = ramp[i - 1];
+            const auto &b = ramp[i];
+            const float t = static_cast<float>(tick - a.tick) / static_cast<float>(b.tick - a.tick);
+            return a.rate + t * (b.rate - a.rate);
+        }
+    }
+    return ramp.back().rate;
+}
+
+[[nodiscard]] unsigned Scenario::spawn_count(uint64_t tick) noexcept
+{
+    m_spawn_budget += spawn_rate(tick);
+    const auto count = static_cast<unsigned>(m_spawn_budget);
+    m_spawn_budget -= static_cast<float>(count);
+    return count;
+}
+
+void Scenario::sample(uint64_t tick, size_t entities, size_t enemies, size_t bullets, int64_t frame_ns, const RunStats &stats)
+{
+    m_window_frames++;
+    m_window_frame_ns += frame_ns;
+    m_window_frame_max_ns = std::max(m_window_frame_max_ns, frame_ns);
+    m_peak_entities = std::max(m_peak_entities, entities);
+    m_last_tick = tick;
+
+    /* A reached target closes the window early, so its row describes that population */
+    bool target_reached = false;
+    while (m_next_target < m_config.targets.size() && entities >= m_config.targets[m_next_target])
+    {
+        m_reached.push_back({m_config.targets[m_next_target], tick, to_ms(m_window_frame_ns, m_window_frames)});
+        m_next_target++;
+        target_reached = true;
+    }
+
+    if (target_reached || m_window_frames >= m_config.report_interval)
+        flush_window(tick, entities, enemies, bullets, stats, target_reached);
+}
+
+[[nodiscard]] bool Scenario::finished() const noexcept
+{
+    return !m_config.targets.empty() && m_next_target == m_config.targets.size();
+}
+
+void Scenario::print_summary() const noexcept
+{
+    std::cout << "Scenario '" << m_config.name << "': " << m_reached.size() << "/" << m_config.targets.size()
+              << " targets reached in " << m_last_tick << " ticks, peak " << m_peak_entities << " entities" << std::endl;
+    for (const auto &result : m_reached)
+        std::cout << "  " << result.target << " entities: tick " << result.tick << ", "
+                  << float_to_string(result.frame_ms, 2) << " ms/frame" << std::endl;
+    for (size_t i = m_next_target; i < m_config.targets.size(); ++i)
+        std::cout << "  " << m_config.targets[i] << " entities: not reached" << std::endl;
+}
+
+void Scenario::flush_window(uint64_t tick, size_t entities, size_t enemies, size_t bullets, const RunStats &stats, bool target_reached)
+{
+    SystemTimes window_ns;
+    for (size_t i = 0; i < window_ns.size(); ++i)
+        window_ns[i] = stats.system_ns[i] - m_window_start[i];
+
+    if (m_report.is_open())
+    {
+        m_report << tick << ',' << entities << ',' << enemies << ',' << bullets << ',' << m_window_frames << ','
+                 << to_ms(m_window_frame_ns, m_window_frames) << ',' << to_ms(m_window_frame_max_ns, 1);
+        for (const int64_t ns : window_ns)
+            m_report << ',' << to_ms(ns, m_window_frames);
+        m_report << ',' << (target_reached ? m_reached.back().target : 0) << '\n';
+    }
+
+    if (target_reached && m_print_targets)
+    {
+        std::cout << "Scenario '" << m_config.name << "': " << entities << " entities at tick " << tick << ", frame "
+                  << float_to_string(to_ms(m_window_frame_ns, m_window_frames), 2) << " ms avg, "
+                  << float_to_string(to_ms(m_window_frame_max_ns, 1), 2) << " ms max |";
+        for (size_t i = 0; i < window_ns.size(); ++i)
+            std::cout << ' ' << system_names[i] << ' ' << float_to_string(to_ms(window_ns[i], m_window_frames), 2) << " ms";
+        std::cout << std::endl;
+    }
+
+    m_window_frames = 0;
+    m_window_frame_ns = 0;
+    m_window_frame_max_ns = 0;
+    m_window_start = stats.system_ns;
+}
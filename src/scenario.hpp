@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bot.hpp"
+#include "run_stats.hpp"
+
+/* Point of the spawn rate ramp, the rate is interpolated linearly between points */
+struct SpawnRampPoint
+{
+    uint64_t tick = 0;
+    float rate = 0.0f; /* Enemies per tick */
+};
+
+struct ScenarioConfig
+{
+    std::string name = "";
+    unsigned initial_enemies = 0;
+    std::vector<SpawnRampPoint> ramp; /* Sorted by tick, empty keeps the config spawner */
+    bool forced_berserk = false;      /* Ability always active, the player never stops shooting */
+    std::optional<BotPolicy> bot;     /* Used when no --bot is given */
+    std::vector<uint64_t> targets;    /* Entity counts to reach, the run ends at the last one */
+    uint64_t max_ticks = 0;           /* Used when no --ticks is given, 0: no limit */
+    uint64_t report_interval = 60;    /* Frames per report row */
+    std::string report_filepath = ""; /* CSV of frame time against population, none when empty */
+};
+
+[[nodiscard]] ScenarioConfig load_scenario(const std::string &filepath);
+
+/* Drives the spawn ramp of a stress scenario and reports frame time against population */
+class Scenario
+{
+public:
+    Scenario(const ScenarioConfig &config, bool print_targets = true);
+
+    [[nodiscard]] const ScenarioConfig &config() const noexcept;
+    [[nodiscard]] float spawn_rate(uint64_t tick) const noexcept;
+    [[nodiscard]] unsigned spawn_count(uint64_t tick) noexcept; /* Enemies to spawn this tick, fractional rates accumulate */
+
+    /* Called once per simulated frame, stats must be collected by the game */
+    void sample(uint64_t tick, size_t entities, size_t enemies, size_t bullets, int64_t frame_ns, const RunStats &stats);
+    [[nodiscard]] bool finished() const noexcept;
+    void print_summary() const noexcept;
+
+private:
+    using SystemTimes = std::array<int64_t, static_cast<size_t>(SystemId::Count)>;
+
+    struct TargetResult
+    {
+        uint64_t target = 0;
+        uint64_t tick = 0;
+        double frame_ms = 0.0;
+    };
+
+    ScenarioConfig m_config;
+    bool m_print_targets = true;
+    std::ofstream m_report;
+    float m_spawn_budget = 0.0f;
+
+    /* Current report window */
+    uint64_t m_window_frames = 0;
+    int64_t m_window_frame_ns = 0;
+    int64_t m_window_frame_max_ns = 0;
+    SystemTimes m_window_start = {};
+
+    size_t m_next_target = 0;
+    size_t m_peak_entities = 0;
+    uint64_t m_last_tick = 0;
+    std::vector<TargetResult> m_reached;
+
+    void flush_window(uint64_t tick, size_t entities, size_t enemies, size_t bullets, const RunStats &stats, bool target_reached);
+};
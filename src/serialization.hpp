@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/* Little-endian binary helpers shared by replays and snapshots */
+namespace serial
+{
+    template <typename T>
+    void write_le(std::ostream &out, T value) noexcept
+    {
+        for (size_t i = 0; i < sizeof(T); ++i)
+            out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    template <typename T>
+    [[nodiscard]] bool read_le(std::istream &in, T &value) noexcept
+    {
+        value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            const int byte = in.get();
+            if (byte == std::char_traits<char>::eof())
+                return false;
+            value |= static_cast<T>(static_cast<uint8_t>(byte)) << (8 * i);
+        }
+        return true;
+    }
+
+    inline void write_float(std::ostream &out, float value) noexcept
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        write_le(out, bits);
+    }
+
+    [[nodiscard]] inline bool read_float(std::istream &in, float &value) noexcept
+    {
+        uint32_t bits = 0;
+        if (!read_le(in, bits))
+            return false;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    inline void write_string(std::ostream &out, const std::string &value) noexcept
+    {
+        write_le(out, static_cast<uint32_t>(value.size()));
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    [[nodiscard]] inline bool read_string(std::istream &in, std::string &value) noexcept
+    {
+        uint32_t size = 0;
+        if (!read_le(in, size))
+            return false;
+
+        /* The size is untrusted, it must fit in what is left of the stream */
+        const std::streampos position = in.tellg();
+        std::streampos end = position;
+        if (position != std::streampos(-1))
+        {
+            in.seekg(0, std::ios_base::end);
+            end = in.tellg();
+            in.seekg(position);
+        }
+        if (!in || position == std::streampos(-1) || end - position < static_cast<std::streamoff>(size))
+        {
+            in.setstate(std::ios_base::failbit);
+            return false;
+        }
+
+        value.resize(size);
+        in.read(value.data(), size);
+        return static_cast<bool>(in);
+    }
+}
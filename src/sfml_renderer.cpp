@@ -0,0 +1,105 @@
+#include "sfml_renderer.hpp"
+
+#include <stdexcept>
+
+#include "profiler.hpp"
+
+SfmlRenderer::SfmlRenderer(sf::RenderWindow &window, const std::string &font_filepath) : m_window(window)
+{
+    if (!m_font.openFromFile(font_filepath))
+        throw std::runtime_error("Could not find " + font_filepath);
+
+    /* Window sized, so the cached glyphs stay pixel exact */
+    if (!m_hud.resize(m_window.getSize()))
+        throw std::runtime_error("Could not create the HUD texture");
+}
+
+void SfmlRenderer::render(const DrawList &list, const sf::View &view)
+{
+    m_window.setView(view);
+    m_window.clear(list.clear_color);
+    m_window.draw(list.triangles);
+
+    /* The view check covers a resized or moved world */
+    const bool view_changed = view.getCenter() != m_hud_view.getCenter() || view.getSize() != m_hud_view.getSize();
+    if (update_texts(list) || view_changed || !m_hud_valid)
+        redraw_hud(list, view);
+
+    /* HUD layer over the whole view */
+    const sf::Vector2f top_left = view.getCenter() - 0.5f * view.getSize();
+    const sf::Vector2f size = view.getSize();
+    const sf::Vector2f texture_size = static_cast<sf::Vector2f>(m_hud.getTexture().getSize());
+    m_hud_quad[0] = {top_left, sf::Color::White, {0.0f, 0.0f}};
+    m_hud_quad[1] = {top_left + sf::Vector2f{size.x, 0.0f}, sf::Color::White, {texture_size.x, 0.0f}};
+    m_hud_quad[2] = {top_left + sf::Vector2f{0.0f, size.y}, sf::Color::White, {0.0f, texture_size.y}};
+    m_hud_quad[3] = {top_left + size, sf::Color::White, texture_size};
+
+    /* The layer was drawn over transparent black, so its colors are premultiplied by alpha */
+    sf::RenderStates states;
+    states.texture = &m_hud.getTexture();
+    states.blendMode = sf::BlendMode(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha);
+    m_window.draw(m_hud_quad, states);
+
+    PROFILE_ZONE("display");
+    m_window.display();
+}
+
+[[nodiscard]] const char *SfmlRenderer::name() const noexcept
+{
+    return to_string(RendererKind::Sfml);
+}
+
+[[nodiscard]] bool SfmlRenderer::update_texts(const DrawList &list)
+{
+    bool changed = m_texts.size() != list.texts.size();
+    while (m_texts.size() < list.texts.size())
+    {
+        m_texts.emplace_back(m_font);
+        m_revisions.push_back(UINT64_MAX);
+        m_visible.push_back(false);
+    }
+
+    for (size_t i = 0; i < list.texts.size(); ++i)
+    {
+        const HudText &hud = list.texts[i];
+        if (m_visible[i] != hud.visible)
+        {
+            m_visible[i] = hud.visible;
+            changed = true;
+        }
+
+        /* Glyph layout only when the line changed */
+        if (m_revisions[i] == hud.revision)
+            continue;
+
+        m_revisions[i] = hud.revision;
+        changed = true;
+
+        sf::Text &text = m_texts[i];
+        text.setString(hud.text);
+        text.setCharacterSize(hud.character_size);
+        text.setFillColor(hud.color);
+        text.setStyle(hud.bold ? sf::Text::Bold : sf::Text::Regular);
+
+        const sf::FloatRect bounds = text.getLocalBounds();
+        text.setOrigin({bounds.position.x + hud.anchor.x * bounds.size.x, bounds.position.y + hud.anchor.y * bounds.size.y});
+        text.setPosition(hud.position);
+    }
+    return changed;
+}
+
+void SfmlRenderer::redraw_hud(const DrawList &list, const sf::View &view) noexcept
+{
+    PROFILE_ZONE("SfmlRenderer::redraw_hud");
+
+    m_hud_view = view;
+    m_hud_valid = true;
+    m_hud.setView(view);
+    m_hud.clear(sf::Color::Transparent);
+    for (size_t i = 0; i < list.texts.size(); ++i)
+    {
+        if (list.texts[i].visible)
+            m_hud.draw(m_texts[i]);
+    }
+    m_hud.display();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "renderer.hpp"
+
+/*
+Draws the list into the game window: one call for the triangles, one for the HUD.
+The HUD lines are rendered into an off-screen texture only when one of them changes,
+and composited every frame as a single textured quad.
+*/
+class SfmlRenderer : public Renderer
+{
+public:
+    SfmlRenderer(sf::RenderWindow &window, const std::string &font_filepath);
+
+    void render(const DrawList &list, const sf::View &view) override;
+    [[nodiscard]] const char *name() const noexcept override;
+
+private:
+    sf::RenderWindow &m_window;
+    sf::Font m_font;
+    std::vector<sf::Text> m_texts; /* One per HUD line, reused between frames */
+    std::vector<uint64_t> m_revisions; /* HUD line revision each sf::Text was laid out for */
+    std::vector<bool> m_visible;       /* HUD line visibility in the cached layer */
+
+    /* Cached HUD layer */
+    sf::RenderTexture m_hud;
+    sf::VertexArray m_hud_quad{sf::PrimitiveType::TriangleStrip, 4};
+    sf::View m_hud_view;
+    bool m_hud_valid = false;
+
+    /* Lays out the changed lines, returns true when the cached layer must be redrawn */
+    [[nodiscard]] bool update_texts(const DrawList &list);
+    void redraw_hud(const DrawList &list, const sf::View &view) noexcept;
+
+    SfmlRenderer(const SfmlRenderer &) = delete;
+    SfmlRenderer &operator=(const SfmlRenderer &) = delete;
+};
@@ -0,0 +1,100 @@
+#include "shape_batch.hpp"
+
+#include "polygon_table.hpp"
+#include "profiler.hpp"
+
+namespace
+{
+    /* Regular polygon as a triangle list: a fan from the center, then the outline ring outside of it */
+    void write_shape(sf::Vertex *out, const sf::Vector2f &center, const CShape &shape, uint32_t points, uint8_t alpha) noexcept
+    {
+        /* Scaled and rotated unit polygon */
+        const sf::Vector2f r = polygon::rotation(sf::degrees(shape.rotation));
+        const auto corner = [&](size_t i, float radius)
+        {
+            const sf::Vector2f v = radius * polygon::vertex(i, points);
+            return center + sf::Vector2f{v.x * r.x - v.y * r.y, v.x * r.y + v.y * r.x};
+        };
+
+        sf::Color fill = shape.fill_color;
+        fill.a = static_cast<uint8_t>(fill.a * alpha / 255);
+        sf::Vector2f previous = corner(0, shape.radius);
+        for (size_t i = 1; i <= points; ++i)
+        {
+            const sf::Vector2f current = corner(i, shape.radius);
+            *out++ = {center, fill};
+            *out++ = {previous, fill};
+            *out++ = {current, fill};
+            previous = current;
+        }
+
+        if (shape.outline_thickness <= 0.0f)
+            return;
+
+        sf::Color outline = shape.outline_color;
+        outline.a = static_cast<uint8_t>(outline.a * alpha / 255);
+        const float outer_radius = shape.radius + shape.outline_thickness;
+        sf::Vector2f inner = corner(0, shape.radius);
+        sf::Vector2f outer = corner(0, outer_radius);
+        for (size_t i = 1; i <= points; ++i)
+        {
+            const sf::Vector2f next_inner = corner(i, shape.radius);
+            const sf::Vector2f next_outer = corner(i, outer_radius);
+            *out++ = {inner, outline};
+            *out++ = {outer, outline};
+            *out++ = {next_outer, outline};
+            *out++ = {inner, outline};
+            *out++ = {next_outer, outline};
+            *out++ = {next_inner, outline};
+            inner = next_inner;
+            outer = next_outer;
+        }
+    }
+}
+
+void ShapeBatch::clear() noexcept
+{
+    m_instances.clear();
+    m_vertex_count = 0;
+}
+
+void ShapeBatch::add(const sf::Vector2f &center, const CShape &shape, uint32_t points, uint8_t alpha)
+{
+    m_instances.push_back({center, shape, points, alpha, m_vertex_count});
+    m_vertex_count += vertex_count(points, shape.outline_thickness > 0.0f);
+}
+
+void ShapeBatch::build(sf::VertexArray &triangles, ThreadPool *pool) const
+{
+    /* Same size as the previous frame most of the time, then nothing is reallocated or reinitialized */
+    triangles.resize(m_vertex_count);
+    if (m_vertex_count == 0)
+        return;
+
+    sf::Vertex *vertices = &triangles[0];
+    const auto fill = [this, vertices](size_t begin, size_t end)
+    {
+        PROFILE_ZONE("build_vertices_chunk");
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Instance &instance = m_instances[i];
+            write_shape(vertices + instance.first_vertex, instance.center, instance.shape, instance.points, instance.alpha);
+        }
+    };
+
+    if (pool)
+        pool->parallel_for(m_instances.size(), min_chunk, fill);
+    else
+        fill(0, m_instances.size());
+}
+
+[[nodiscard]] size_t ShapeBatch::vertex_count() const noexcept
+{
+    return m_vertex_count;
+}
+
+[[nodiscard]] size_t ShapeBatch::vertex_count(uint32_t points, bool outline) noexcept
+{
+    /* A fan triangle per side, two more per side for the outline ring */
+    return (outline ? 9 : 3) * static_cast<size_t>(points);
+}
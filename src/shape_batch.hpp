@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "components.hpp"
+#include "thread_pool.hpp"
+
+/*
+Turns the shapes of a frame into one triangle list.
+Shapes are queued in draw order and each one gets a fixed range of the vertex array from a prefix sum,
+then the ranges are filled in parallel chunks: no two chunks write the same vertex, so no locks are needed.
+*/
+class ShapeBatch
+{
+public:
+    static constexpr size_t min_chunk = 256; /* Shapes per job, smaller frames are built on the calling thread */
+
+    void clear() noexcept;
+
+    /* points may be lower than the shape side count, see LodPolicy */
+    void add(const sf::Vector2f &center, const CShape &shape, uint32_t points, uint8_t alpha);
+
+    /* Resizes triangles to the queued vertex count and fills it, on the pool when there is one */
+    void build(sf::VertexArray &triangles, ThreadPool *pool) const;
+
+    [[nodiscard]] size_t vertex_count() const noexcept;
+    [[nodiscard]] static size_t vertex_count(uint32_t points, bool outline) noexcept;
+
+private:
+    struct Instance
+    {
+        sf::Vector2f center;
+        CShape shape;
+        uint32_t points = 0;
+        uint8_t alpha = 255;
+        size_t first_vertex = 0;
+    };
+
+    std::vector<Instance> m_instances;
+    size_t m_vertex_count = 0;
+};
@@ -0,0 +1,255 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "game.hpp"
+#include "serialization.hpp"
+
+/*
+World snapshot, little-endian:
+- version (u32)
+- tick (u64), score, highscore, ability duration and cooldown (4 x i32), ability in use (u8), spawner frame count (u32)
+- spawn random stream state (4 x u64)
+- entity id counter (u64), entity count (u64)
+- per entity: tag (string), id (u64), component mask (u8), then each existing component
+*/
+namespace
+{
+    constexpr uint32_t snapshot_version = 3;
+
+    enum ComponentMask : uint8_t
+    {
+        Transform = 1 << 0,
+        LifeSpan = 1 << 1,
+        Input = 1 << 2,
+        Collision = 1 << 3,
+        Score = 1 << 4,
+        Shape = 1 << 5
+    };
+
+    void write_int(std::ostream &out, int value) noexcept
+    {
+        serial::write_le(out, static_cast<uint32_t>(value));
+    }
+
+    [[nodiscard]] int read_int(std::istream &in)
+    {
+        uint32_t value = 0;
+        if (!serial::read_le(in, value))
+            throw std::runtime_error("Truncated snapshot");
+        return static_cast<int>(value);
+    }
+
+    template <typename T>
+    [[nodiscard]] T read_u(std::istream &in)
+    {
+        T value = 0;
+        if (!serial::read_le(in, value))
+            throw std::runtime_error("Truncated snapshot");
+        return value;
+    }
+
+    [[nodiscard]] float read_float(std::istream &in)
+    {
+        float value = 0.0f;
+        if (!serial::read_float(in, value))
+            throw std::runtime_error("Truncated snapshot");
+        return value;
+    }
+
+    void write_vector(std::ostream &out, const sf::Vector2f &v) noexcept
+    {
+        serial::write_float(out, v.x);
+        serial::write_float(out, v.y);
+    }
+
+    [[nodiscard]] sf::Vector2f read_vector(std::istream &in)
+    {
+        const float x = read_float(in);
+        const float y = read_float(in);
+        return {x, y};
+    }
+
+    void write_color(std::ostream &out, const sf::Color &color) noexcept
+    {
+        out.put(static_cast<char>(color.r));
+        out.put(static_cast<char>(color.g));
+        out.put(static_cast<char>(color.b));
+        out.put(static_cast<char>(color.a));
+    }
+
+    [[nodiscard]] sf::Color read_color(std::istream &in)
+    {
+        sf::Color color;
+        color.r = read_u<uint8_t>(in);
+        color.g = read_u<uint8_t>(in);
+        color.b = read_u<uint8_t>(in);
+        color.a = read_u<uint8_t>(in);
+        return color;
+    }
+
+    void write_entity(std::ostream &out, const Entity &e) noexcept
+    {
+        uint8_t mask = 0;
+        mask |= e.has<CTransform>() ? Transform : 0;
+        mask |= e.has<CLifeSpan>() ? LifeSpan : 0;
+        mask |= e.has<CInput>() ? Input : 0;
+        mask |= e.has<CCollision>() ? Collision : 0;
+        mask |= e.has<CScore>() ? Score : 0;
+        mask |= e.has<CShape>() ? Shape : 0;
+
+        serial::write_string(out, e.tag());
+        serial::write_le(out, static_cast<uint64_t>(e.id()));
+        serial::write_le(out, mask);
+
+        if (mask & Transform)
+        {
+            const auto &transform = e.get<CTransform>();
+            write_vector(out, transform.pos);
+            write_vector(out, transform.velocity);
+            serial::write_float(out, transform.angle);
+        }
+
+        if (mask & LifeSpan)
+        {
+            const auto &lifespan = e.get<CLifeSpan>();
+            write_int(out, lifespan.lifespan);
+            write_int(out, lifespan.remaining);
+        }
+
+        if (mask & Input)
+        {
+            const auto &input = e.get<CInput>();
+            const uint8_t buttons = input.up | input.down << 1 | input.left << 2 | input.right << 3 | input.shoot << 4 | input.ability << 5;
+            serial::write_le(out, buttons);
+            write_vector(out, input.aim);
+        }
+
+        if (mask & Collision)
+            serial::write_float(out, e.get<CCollision>().radius);
+
+        if (mask & Score)
+            write_int(out, e.get<CScore>().score);
+
+        if (mask & Shape)
+        {
+            const auto &shape = e.get<CShape>();
+            serial::write_float(out, shape.radius);
+            serial::write_le(out, shape.points);
+            write_color(out, shape.fill_color);
+            write_color(out, shape.outline_color);
+            serial::write_float(out, shape.outline_thickness);
+            serial::write_float(out, shape.rotation);
+        }
+    }
+
+    void read_entity(std::istream &in, EntityManager &entities)
+    {
+        std::string tag;
+        if (!serial::read_string(in, tag))
+            throw std::runtime_error("Truncated snapshot");
+        const auto id = read_u<uint64_t>(in);
+        const auto mask = read_u<uint8_t>(in);
+
+        auto e = entities.restore_entity(tag, id);
+
+        if (mask & Transform)
+        {
+            const sf::Vector2f pos = read_vector(in);
+            const sf::Vector2f velocity = read_vector(in);
+            e->add<CTransform>(pos, velocity, read_float(in));
+        }
+
+        if (mask & LifeSpan)
+        {
+            const int lifespan = read_int(in);
+            e->add<CLifeSpan>(lifespan);
+            e->get<CLifeSpan>().remaining = read_int(in);
+        }
+
+        if (mask & Input)
+        {
+            const auto buttons = read_u<uint8_t>(in);
+            e->add<CInput>();
+            auto &input = e->get<CInput>();
+            input.up = buttons & 1;
+            input.down = buttons & 2;
+            input.left = buttons & 4;
+            input.right = buttons & 8;
+            input.shoot = buttons & 16;
+            input.ability = buttons & 32;
+            input.aim = read_vector(in);
+        }
+
+        if (mask & Collision)
+            e->add<CCollision>(read_float(in));
+
+        if (mask & Score)
+            e->add<CScore>(read_int(in));
+
+        if (mask & Shape)
+        {
+            const float radius = read_float(in);
+            const auto points = read_u<uint32_t>(in);
+            const sf::Color color = read_color(in);
+            e->add<CShape>(radius, points, color);
+            auto &shape = e->get<CShape>();
+            shape.outline_color = read_color(in);
+            shape.outline_thickness = read_float(in);
+            shape.rotation = read_float(in);
+        }
+    }
+}
+
+[[nodiscard]] std::string Game::save_snapshot() noexcept
+{
+    std::ostringstream out(std::ios::binary);
+
+    serial::write_le(out, snapshot_version);
+    serial::write_le(out, m_tick);
+    write_int(out, m_score);
+    write_int(out, m_highscore);
+    write_int(out, m_duration_remaining);
+    write_int(out, m_cooldown_remaining);
+    serial::write_le(out, static_cast<uint8_t>(m_using_ability));
+    serial::write_le(out, static_cast<uint32_t>(m_spawn_frame_count));
+
+    for (const uint64_t word : m_spawn_rng.state())
+        serial::write_le(out, word);
+
+    /* Snapshots are taken after EntityManager::update, so there are no pending entities */
+    const auto &entities = m_entities.get_entities();
+    serial::write_le(out, static_cast<uint64_t>(m_entities.total_entities()));
+    serial::write_le(out, static_cast<uint64_t>(entities.size()));
+    for (const auto &e : entities)
+        write_entity(out, *e);
+
+    return out.str();
+}
+
+void Game::load_snapshot(const std::string &snapshot)
+{
+    std::istringstream in(snapshot, std::ios::binary);
+
+    if (read_u<uint32_t>(in) != snapshot_version)
+        throw std::runtime_error("Unsupported snapshot version");
+
+    m_tick = read_u<uint64_t>(in);
+    m_score = read_int(in);
+    m_highscore = read_int(in);
+    m_duration_remaining = read_int(in);
+    m_cooldown_remaining = read_int(in);
+    m_using_ability = read_u<uint8_t>(in) != 0;
+    m_spawn_frame_count = read_u<uint32_t>(in);
+
+    Rng::State spawn_rng_state;
+    for (auto &word : spawn_rng_state)
+        word = read_u<uint64_t>(in);
+    m_spawn_rng.set_state(spawn_rng_state);
+
+    const auto total_entities = read_u<uint64_t>(in);
+    const auto count = read_u<uint64_t>(in);
+    m_entities.clear(total_entities);
+    for (uint64_t i = 0; i < count; ++i)
+        read_entity(in, m_entities);
+    m_entities.update();
+}
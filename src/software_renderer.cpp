@@ -0,0 +1,301 @@
+#include "software_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#include "bitmap_font.hpp"
+#include "profiler.hpp"
+
+namespace
+{
+    constexpr int64_t subpixels = 256;
+
+    [[nodiscard]] int64_t floor_div(int64_t value, int64_t divisor) noexcept
+    {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    /* Twice the signed area of (a, b, p), positive when p is on the inner side of a -> b */
+    template <typename Point>
+    [[nodiscard]] int64_t edge(const Point &a, const Point &b, int64_t px, int64_t py) noexcept
+    {
+        return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+    }
+
+    /* Fill rule for pixel centers exactly on an edge: a shared edge belongs to exactly one of its two triangles */
+    template <typename Point>
+    [[nodiscard]] bool owns_edge(const Point &a, const Point &b) noexcept
+    {
+        const int64_t dy = b.y - a.y;
+        return dy > 0 || (dy == 0 && b.x < a.x);
+    }
+
+    [[nodiscard]] bool ends_with(const std::string &value, const std::string &suffix) noexcept
+    {
+        return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(const sf::Vector2u &size, ThreadPool &pool) : m_size(size),
+                                                                                 m_pixels(static_cast<size_t>(size.x) * size.y * 4, 0),
+                                                                                 m_tiles_x((size.x + tile_size - 1) / tile_size),
+                                                                                 m_tiles_y((size.y + tile_size - 1) / tile_size),
+                                                                                 m_bins(static_cast<size_t>(m_tiles_x) * m_tiles_y),
+                                                                                 m_pool(pool)
+{
+}
+
+void SoftwareRenderer::render(const DrawList &list, const sf::View &view)
+{
+    clear(list.clear_color);
+    draw(list.triangles, view);
+    for (const HudText &text : list.texts)
+    {
+        if (text.visible)
+            draw_text(text, view);
+    }
+}
+
+[[nodiscard]] const char *SoftwareRenderer::name() const noexcept
+{
+    return to_string(RendererKind::Software);
+}
+
+void SoftwareRenderer::clear(const sf::Color &color) noexcept
+{
+    for (size_t i = 0; i < m_pixels.size(); i += 4)
+    {
+        m_pixels[i] = color.r;
+        m_pixels[i + 1] = color.g;
+        m_pixels[i + 2] = color.b;
+        m_pixels[i + 3] = color.a;
+    }
+}
+
+void SoftwareRenderer::draw(const sf::VertexArray &triangles, const sf::View &view)
+{
+    PROFILE_ZONE("SoftwareRenderer::draw");
+
+    const size_t count = triangles.getVertexCount() / 3;
+    const sf::Vector2f origin = view.getCenter() - 0.5f * view.getSize();
+    const sf::Vector2f scale = {static_cast<float>(m_size.x) / view.getSize().x, static_cast<float>(m_size.y) / view.getSize().y};
+
+    for (auto &bin : m_bins)
+        bin.clear();
+
+    /* Transform and bin */
+    m_points.resize(3 * count);
+    for (size_t t = 0; t < count; ++t)
+    {
+        int64_t xmin = INT64_MAX, xmax = INT64_MIN, ymin = INT64_MAX, ymax = INT64_MIN;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const sf::Vector2f position = triangles[3 * t + k].position - origin;
+            auto &point = m_points[3 * t + k];
+            point.x = std::llround(position.x * scale.x * subpixels);
+            point.y = std::llround(position.y * scale.y * subpixels);
+            xmin = std::min(xmin, point.x);
+            xmax = std::max(xmax, point.x);
+            ymin = std::min(ymin, point.y);
+            ymax = std::max(ymax, point.y);
+        }
+
+        const int64_t px_min = std::max<int64_t>(0, floor_div(xmin, subpixels));
+        const int64_t px_max = std::min<int64_t>(m_size.x - 1, floor_div(xmax, subpixels));
+        const int64_t py_min = std::max<int64_t>(0, floor_div(ymin, subpixels));
+        const int64_t py_max = std::min<int64_t>(m_size.y - 1, floor_div(ymax, subpixels));
+        if (px_min > px_max || py_min > py_max)
+            continue;
+
+        for (int64_t ty = py_min / tile_size; ty <= py_max / tile_size; ++ty)
+        {
+            for (int64_t tx = px_min / tile_size; tx <= px_max / tile_size; ++tx)
+                m_bins[ty * m_tiles_x + tx].push_back(static_cast<uint32_t>(t));
+        }
+    }
+
+    /* Tiles are independent, and rasterize_tile does not throw */
+    const ThreadPool::WaitGuard guard(m_pool);
+    for (size_t tile = 0; tile < m_bins.size(); ++tile)
+    {
+        if (!m_bins[tile].empty())
+            m_pool.submit([this, tile, &triangles]
+                          { rasterize_tile(tile, triangles); });
+    }
+}
+
+void SoftwareRenderer::draw_text(const HudText &text, const sf::View &view) noexcept
+{
+    const int pixel = static_cast<int>(std::max(1u, text.character_size / 8));
+    const sf::Vector2f size = text_size(text.text, text.character_size);
+    const sf::Vector2f position = text.position - sf::Vector2f{text.anchor.x * size.x, text.anchor.y * size.y};
+    const sf::Vector2f origin = view.getCenter() - 0.5f * view.getSize();
+    const int x0 = static_cast<int>(std::lround((position.x - origin.x) * static_cast<float>(m_size.x) / view.getSize().x));
+    int y = static_cast<int>(std::lround((position.y - origin.y) * static_cast<float>(m_size.y) / view.getSize().y));
+    int x = x0;
+
+    for (const char c : text.text)
+    {
+        if (c == '\n')
+        {
+            x = x0;
+            y += bitmap_font::line_height * pixel;
+            continue;
+        }
+
+        const auto &glyph = bitmap_font::glyph(c);
+        for (int row = 0; row < bitmap_font::glyph_height; ++row)
+        {
+            for (int column = 0; column < bitmap_font::glyph_width; ++column)
+            {
+                if (!(glyph[row] & (1 << (bitmap_font::glyph_width - 1 - column))))
+                    continue;
+
+                /* One font pixel is a pixel x pixel block */
+                for (int by = y + row * pixel; by < y + (row + 1) * pixel; ++by)
+                {
+                    for (int bx = x + column * pixel; bx < x + (column + 1) * pixel; ++bx)
+                    {
+                        if (bx >= 0 && by >= 0 && bx < static_cast<int>(m_size.x) && by < static_cast<int>(m_size.y))
+                            blend((static_cast<size_t>(by) * m_size.x + bx) * 4, text.color);
+                    }
+                }
+            }
+        }
+        x += bitmap_font::advance * pixel;
+    }
+}
+
+[[nodiscard]] sf::Vector2f SoftwareRenderer::text_size(const std::string &text, unsigned character_size) noexcept
+{
+    const int pixel = static_cast<int>(std::max(1u, character_size / 8));
+    size_t columns = 0;
+    size_t line = 0;
+    size_t lines = 1;
+    for (const char c : text)
+    {
+        if (c == '\n')
+        {
+            lines++;
+            line = 0;
+            continue;
+        }
+        columns = std::max(columns, ++line);
+    }
+
+    const int width = columns > 0 ? static_cast<int>(columns) * bitmap_font::advance - 1 : 0;
+    const int height = static_cast<int>(lines - 1) * bitmap_font::line_height + bitmap_font::glyph_height;
+    return {static_cast<float>(width * pixel), static_cast<float>(height * pixel)};
+}
+
+[[nodiscard]] const std::vector<uint8_t> &SoftwareRenderer::pixels() const noexcept
+{
+    return m_pixels;
+}
+
+[[nodiscard]] const sf::Vector2u &SoftwareRenderer::size() const noexcept
+{
+    return m_size;
+}
+
+void SoftwareRenderer::save_frame(const std::string &filepath) const
+{
+    if (!ends_with(filepath, ".ppm"))
+    {
+        if (!sf::Image(m_size, m_pixels.data()).saveToFile(filepath))
+            throw std::runtime_error("Could not write " + filepath);
+        return;
+    }
+
+    std::ofstream out(filepath, std::ios::binary);
+    if (!out)
+        throw std::runtime_error("Could not write " + filepath);
+    out << "P6\n"
+        << m_size.x << ' ' << m_size.y << "\n255\n";
+    for (size_t i = 0; i < m_pixels.size(); i += 4)
+        out.write(reinterpret_cast<const char *>(&m_pixels[i]), 3);
+}
+
+void SoftwareRenderer::rasterize_tile(size_t tile, const sf::VertexArray &triangles) noexcept
+{
+    PROFILE_ZONE("rasterize_tile");
+
+    const int64_t tile_x0 = static_cast<int64_t>(tile % m_tiles_x) * tile_size;
+    const int64_t tile_y0 = static_cast<int64_t>(tile / m_tiles_x) * tile_size;
+    const int64_t tile_x1 = std::min<int64_t>(tile_x0 + tile_size, m_size.x);
+    const int64_t tile_y1 = std::min<int64_t>(tile_y0 + tile_size, m_size.y);
+
+    for (const uint32_t t : m_bins[tile])
+    {
+        const sf::Color color = triangles[3 * static_cast<size_t>(t)].color;
+        if (color.a == 0)
+            continue;
+
+        FixedPoint a = m_points[3 * static_cast<size_t>(t)];
+        FixedPoint b = m_points[3 * static_cast<size_t>(t) + 1];
+        FixedPoint c = m_points[3 * static_cast<size_t>(t) + 2];
+        const int64_t area = edge(a, b, c.x, c.y);
+        if (area == 0)
+            continue;
+        if (area < 0)
+            std::swap(b, c);
+
+        const int64_t x0 = std::max(tile_x0, floor_div(std::min({a.x, b.x, c.x}), subpixels));
+        const int64_t x1 = std::min(tile_x1 - 1, floor_div(std::max({a.x, b.x, c.x}), subpixels));
+        const int64_t y0 = std::max(tile_y0, floor_div(std::min({a.y, b.y, c.y}), subpixels));
+        const int64_t y1 = std::min(tile_y1 - 1, floor_div(std::max({a.y, b.y, c.y}), subpixels));
+        if (x0 > x1 || y0 > y1)
+            continue;
+
+        /* Edge functions at the first pixel center, stepped incrementally; pixels are inside when all three are >= 0 */
+        const int64_t px = x0 * subpixels + subpixels / 2;
+        const int64_t py = y0 * subpixels + subpixels / 2;
+        int64_t row0 = edge(b, c, px, py) - (owns_edge(b, c) ? 0 : 1);
+        int64_t row1 = edge(c, a, px, py) - (owns_edge(c, a) ? 0 : 1);
+        int64_t row2 = edge(a, b, px, py) - (owns_edge(a, b) ? 0 : 1);
+        const int64_t step_x0 = -(c.y - b.y) * subpixels, step_y0 = (c.x - b.x) * subpixels;
+        const int64_t step_x1 = -(a.y - c.y) * subpixels, step_y1 = (a.x - c.x) * subpixels;
+        const int64_t step_x2 = -(b.y - a.y) * subpixels, step_y2 = (b.x - a.x) * subpixels;
+
+        for (int64_t y = y0; y <= y1; ++y)
+        {
+            int64_t w0 = row0, w1 = row1, w2 = row2;
+            size_t offset = (static_cast<size_t>(y) * m_size.x + static_cast<size_t>(x0)) * 4;
+            for (int64_t x = x0; x <= x1; ++x)
+            {
+                if ((w0 | w1 | w2) >= 0)
+                    blend(offset, color);
+                w0 += step_x0;
+                w1 += step_x1;
+                w2 += step_x2;
+                offset += 4;
+            }
+            row0 += step_y0;
+            row1 += step_y1;
+            row2 += step_y2;
+        }
+    }
+}
+
+void SoftwareRenderer::blend(size_t offset, const sf::Color &color) noexcept
+{
+    uint8_t *pixel = &m_pixels[offset];
+    if (color.a == 255)
+    {
+        pixel[0] = color.r;
+        pixel[1] = color.g;
+        pixel[2] = color.b;
+        pixel[3] = 255;
+        return;
+    }
+
+    /* Source over, straight alpha */
+    const unsigned alpha = color.a;
+    const unsigned inverse = 255 - alpha;
+    pixel[0] = static_cast<uint8_t>((color.r * alpha + pixel[0] * inverse + 127) / 255);
+    pixel[1] = static_cast<uint8_t>((color.g * alpha + pixel[1] * inverse + 127) / 255);
+    pixel[2] = static_cast<uint8_t>((color.b * alpha + pixel[2] * inverse + 127) / 255);
+    pixel[3] = static_cast<uint8_t>(alpha + (pixel[3] * inverse + 127) / 255);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "renderer.hpp"
+#include "thread_pool.hpp"
+
+/*
+CPU rasterizer into an RGBA framebuffer, no OpenGL context needed.
+The framebuffer is split in tiles, triangles are binned per tile and every tile is rasterized
+by a worker thread, so tiles never share pixels and no locks are needed.
+Triangles are flat shaded with the color of their first vertex and alpha blended in submission order.
+*/
+class SoftwareRenderer : public Renderer
+{
+public:
+    static constexpr unsigned tile_size = 64;
+
+    /* Tiles are rasterized on the pool, which must outlive the renderer */
+    SoftwareRenderer(const sf::Vector2u &size, ThreadPool &pool);
+
+    void render(const DrawList &list, const sf::View &view) override;
+
+    /* Binary PPM for .ppm paths, any format supported by sf::Image otherwise */
+    void save_frame(const std::string &filepath) const override;
+    [[nodiscard]] const char *name() const noexcept override;
+
+    void clear(const sf::Color &color) noexcept;
+    void draw(const sf::VertexArray &triangles, const sf::View &view);
+    void draw_text(const HudText &text, const sf::View &view) noexcept;
+
+    /* Size of a text in pixels, with the built-in bitmap font */
+    [[nodiscard]] static sf::Vector2f text_size(const std::string &text, unsigned character_size) noexcept;
+
+    [[nodiscard]] const std::vector<uint8_t> &pixels() const noexcept;
+    [[nodiscard]] const sf::Vector2u &size() const noexcept;
+
+private:
+    /* Vertex positions in 24.8 fixed point pixels */
+    struct FixedPoint
+    {
+        int64_t x = 0;
+        int64_t y = 0;
+    };
+
+    sf::Vector2u m_size;
+    std::vector<uint8_t> m_pixels;
+    unsigned m_tiles_x = 0;
+    unsigned m_tiles_y = 0;
+    std::vector<std::vector<uint32_t>> m_bins; /* Triangle indices per tile */
+    std::vector<FixedPoint> m_points;
+    ThreadPool &m_pool;
+
+    void rasterize_tile(size_t tile, const sf::VertexArray &triangles) noexcept;
+    void blend(size_t offset, const sf::Color &color) noexcept;
+
+    SoftwareRenderer(const SoftwareRenderer &) = delete;
+    SoftwareRenderer &operator=(const SoftwareRenderer &) = delete;
+};
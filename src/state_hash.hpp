@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/* Cheap incremental 64-bit hash of simulation state, bit exact on floats */
+class StateHash
+{
+public:
+    void add(uint64_t value) noexcept
+    {
+        m_hash = (m_hash ^ value) * prime;
+        m_hash ^= m_hash >> 32;
+    }
+
+    void add(int value) noexcept
+    {
+        add(static_cast<uint64_t>(static_cast<uint32_t>(value)));
+    }
+
+    void add(float value) noexcept
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        add(static_cast<uint64_t>(bits));
+    }
+
+    void add(float x, float y) noexcept
+    {
+        uint32_t bx = 0;
+        uint32_t by = 0;
+        std::memcpy(&bx, &x, sizeof(bx));
+        std::memcpy(&by, &y, sizeof(by));
+        add(static_cast<uint64_t>(bx) << 32 | by);
+    }
+
+    [[nodiscard]] uint64_t value() const noexcept
+    {
+        return m_hash;
+    }
+
+private:
+    static constexpr uint64_t prime = 0x100000001b3ULL;
+    uint64_t m_hash = 0xcbf29ce484222325ULL;
+};
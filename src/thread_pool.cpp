@@ -0,0 +1,74 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t thread_count)
+{
+    if (thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    m_threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+        m_threads.emplace_back(&ThreadPool::worker, this);
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_job_available.notify_all();
+
+    for (auto &thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_job_available.notify_one();
+}
+
+void ThreadPool::wait() noexcept
+{
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this]
+                { return m_jobs.empty() && m_active == 0; });
+}
+
+[[nodiscard]] size_t ThreadPool::size() const noexcept
+{
+    return m_threads.size();
+}
+
+void ThreadPool::worker() noexcept
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_job_available.wait(lock, [this]
+                                 { return m_stopping || !m_jobs.empty(); });
+            if (m_jobs.empty())
+                return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_active++;
+        }
+
+        job();
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_active--;
+            if (m_jobs.empty() && m_active == 0)
+                m_idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed set of worker threads consuming a FIFO job queue */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool() noexcept;
+
+    void submit(std::function<void()> job);
+    void wait() noexcept;
+
+    /* Waits on scope exit, so jobs referencing the caller's locals never outlive them, even when submit throws */
+    class WaitGuard
+    {
+    public:
+        explicit WaitGuard(ThreadPool &pool) noexcept : m_pool(pool)
+        {
+        }
+
+        ~WaitGuard() noexcept
+        {
+            m_pool.wait();
+        }
+
+        WaitGuard(const WaitGuard &) = delete;
+        WaitGuard &operator=(const WaitGuard &) = delete;
+
+    private:
+        ThreadPool &m_pool;
+    };
+
+    /*
+    Runs body(begin, end) over [0, count) in contiguous chunks of at least min_chunk items, one per worker plus the
+    first chunk on the calling thread. It ends with wait(), which waits for every job of the shared pool, not only
+    these chunks: jobs submitted by other callers meanwhile delay the return.
+    The first exception thrown by a chunk is rethrown once every chunk is done.
+    */
+    template <typename Body>
+    void parallel_for(size_t count, size_t min_chunk, const Body &body)
+    {
+        const size_t chunks = std::min(size() + 1, count / std::max<size_t>(min_chunk, 1));
+        if (chunks <= 1)
+        {
+            if (count > 0)
+                body(size_t{0}, count);
+            return;
+        }
+
+        /* Workers must not throw, chunks keep their first exception for the caller */
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        const auto run = [&body, &error, &error_mutex](size_t begin, size_t end) noexcept
+        {
+            try
+            {
+                body(begin, end);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        const size_t chunk = (count + chunks - 1) / chunks;
+        {
+            const WaitGuard guard(*this);
+            for (size_t begin = chunk; begin < count; begin += chunk)
+            {
+                const size_t end = std::min(begin + chunk, count);
+                submit([&run, begin, end]
+                       { run(begin, end); });
+            }
+            run(size_t{0}, chunk);
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    [[nodiscard]] size_t size() const noexcept;
+
+private:
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_job_available;
+    std::condition_variable m_idle;
+    size_t m_active = 0;
+    bool m_stopping = false;
+
+    void worker() noexcept;
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+};